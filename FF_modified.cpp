@@ -1,404 +1,440 @@
 #include <iostream>
 #include <vector>
-#include <climits>
-#include <queue>
 #include <chrono>
+#include <cstdlib>
+#include <string>
 #include <fstream>
+#include <cstring>
+#include <cerrno>
+#include "maxflow.h"
+#include "gomory_hu.h"
+#include "reduction.h"
+#include "result_export.h"
 using namespace std;
 typedef std::chrono::high_resolution_clock Clock;
-struct Edge
+
+/**
+ * @brief Command line settings of one run.
+ */
+struct Options
 {
-    int u, v;     // Source and destination nodes
-    int capacity; // Capacity of the edge
-    int flow;     // Current flow on the edge
-    // Edge* residual;        // Pointer to the residual edge in the residual graph
- 
-    // Constructor to initialize the edge
-    /**
-     * @brief Constructor for creating a new Edge instance.
-     *
-     * @param u The source vertex of the edge.
-     * @param v The destination vertex of the edge.
-     * @param capacity The capacity of the edge.
-     */
-    Edge(int u, int v, int capacity) : u(u), v(v), capacity(capacity), flow(0) {}
+    FlowAlgorithm algorithm;
+    int threads;        // 0 keeps the hardware concurrency
+    bool scaling;       // capacity scaling for ff and ek
+    bool value_only;    // only print the cut value, skipping the flow assignment and the cut edges
+    string input;
+    string snapshot;    // --convert: write the graph as a binary snapshot and exit
+    bool snapshot_flow; // solve first and store the flow in the snapshot
+    string stats_path;  // --stats: write the solver counters as JSON, - for stdout
+    string pairs_path;  // --cut-tree: answer the min cut of every `u v` line from a Gomory-Hu tree
+    string capacity;    // --capacity: int, int64 or unit
+    bool reduce;        // prune, merge and contract the graph before solving
+    string export_path; // --export: flows and cut as .json, .dot or .bin, none to skip
+    string paths_path;  // --paths: the flow split into paths and cycles, - for stdout
+    string min_cost;    // --min-cost: ssp or scaling, the max flow of least cost over the fourth input column
 };
- 
+
 /**
- * @brief Represents a residual edge in a graph, which is an Edge with additional information.
+ * @brief Writes every piece of a flow decomposition as `path|cycle amount: v0 v1 ... vk`.
  */
-struct ResidualEdge : Edge
+template <class Cap>
+struct PathPrinter : FlowPathSink<typename BasicGraph<Cap>::Flow>
 {
-    int forward_edge_idx;  // Index of the forward edge in the adjacency list
-    int backward_edge_idx; // Index of the backward edge in the adjacency list
-  /**
-     * @brief Constructor for creating a new ResidualEdge instance.
-     *
-     * @param u The source vertex of the residual edge.
-     * @param v The destination vertex of the residual edge.
-     * @param capacity The capacity of the residual edge.
-     * @param forward_edge_idx The index of the corresponding forward edge in the adjacency list.
-     * @param backward_edge_idx The index of the corresponding backward edge in the adjacency list.
-     */
-    // Constructor to initialize the residual edge
-    ResidualEdge(int u, int v, int capacity, int forward_edge_idx, int backward_edge_idx) : Edge(u, v, capacity), forward_edge_idx(forward_edge_idx), backward_edge_idx(backward_edge_idx) {}
+    const BasicGraph<Cap> &G;
+    ostream &out;
+
+    PathPrinter(const BasicGraph<Cap> &G, ostream &out) : G(G), out(out) {}
+    void emit(const vector<int> &path, typename BasicGraph<Cap>::Flow amount, bool cycle)
+    {
+        out << (cycle ? "cycle " : "path ") << (long long)amount << ": " << G.edges[path[0]].u;
+        for (size_t i = 0; i < path.size(); i++)
+        {
+            out << " " << G.edges[path[i]].v;
+        }
+        out << "\n";
+    }
 };
- 
-class Graph
+
+// answers the --cut-tree queries, the edges are read as undirected and one tree answers every pair
+static int answer_pairs(Graph &G, const Options &o)
 {
-public:
-    int n;                                       // number of vertices in the graph
-    vector<vector<Edge *>> adj;                  // adjacency matrix to store the edges in the graph
-    vector<vector<ResidualEdge *>> residual_adj; // adjacency matrix to store the edges in the residual graph
-    // vector<bool> visited;                        // to keep track of visited nodes while calculation the augmented path
- 
-    // constructor to initialize the graph
-    /**
-     * @brief Construct a new Graph object with the given number of vertices.
-     * 
-     * @param n The number of vertices in the graph.
-     */
-    Graph(int n);
- 
-    // method to add an edge to the graph
-    /**
-     * @brief Add an edge to the graph with the given source, destination, and capacity.
-     * 
-     * @param x An addEdgeObj object containing the source, destination, and capacity of the edge to be added.
-     */
-    void add_edge(int u, int v, int capacity);
- 
-    // method to create the residual graph from the original graph
-    /**
-     * @brief Creates the residual graph of the current graph.
-     */
-    void create_residual_graph();
- 
-    // method to find an augmenting path in the residual graph using DFS
-    /**
-     * @brief Performs a depth-first search (DFS) to find an augmenting path in the residual graph.
-     * 
-     * @param s The current vertex being visited.
-     * @param t The sink vertex.
-     * @param parent A vector of ResidualEdge pointers representing the parent of each vertex in the DFS tree.
-     * @param visited A vector of booleans representing whether each vertex has been visited or not.
-     * @return true if an augmenting path is found, false otherwise.
-     */
-    bool dfs(int source, int sink, vector<ResidualEdge *> &parent, vector<bool> &visited);
-    vector<ResidualEdge *> find_augmenting_path(int source, int sink);
- 
-    // method to run the Ford-Fulkerson algorithm on the graph
-    int max_flow(int source, int sink);
- 
-    // method to implement st_cut
-    vector<pair<int, int>> st_cut(int source, int sink);
- 
-    //helper function for the st_cut
-    void dfs_cut(int u, int sink, vector<bool> &visited);
- 
-};
- 
-Graph::Graph(int n)
+    ifstream pairs(o.pairs_path.c_str());
+    if (!pairs)
+    {
+        cerr << o.pairs_path << ": cannot open" << endl;
+        return 1;
+    }
+    GomoryHuTree T;
+    T.build(G, G.threads, o.algorithm);
+    int u, v;
+    while (pairs >> u >> v)
+    {
+        if (u < 0 || v < 0 || u >= G.n || v >= G.n || u == v)
+        {
+            cerr << o.pairs_path << ": bad pair " << u << " " << v << endl;
+            return 1;
+        }
+        vector<pair<int, int>> cut = T.cut_edges(u, v);
+        cout << "min cut " << u << " " << v << ": " << T.min_cut_value(u, v) << endl;
+        for (int i = 0; i < (int)cut.size(); i++)
+        {
+            cout << cut[i].first << " " << cut[i].second << endl;
+        }
+    }
+    return 0;
+}
+
+template <class Cap>
+static int answer_pairs(BasicGraph<Cap> &, const Options &)
 {
-    this->n = n;
-    adj.resize(n, vector<Edge *>(n, nullptr));
-    residual_adj.resize(n, vector<ResidualEdge *>(n, nullptr));
-    // visited.resize(n, false);
+    cerr << "--cut-tree needs --capacity int" << endl;
+    return 1;
 }
-/**
-     * @brief Add an edge to the graph with the given source, destination, and capacity.
-     * 
-     * @param x An addEdgeObj object containing the source, destination, and capacity of the edge to be added.
-     */
-void Graph::add_edge(int u, int v, int capacity)
+
+// solves the reduced graph instead of G, the flow and the cut are mapped back onto G
+template <class Cap>
+static long long solve_reduced(BasicGraph<Cap> &G, int source, int sink, const Options &o, CutResult &cut)
 {
-    Edge *e = new Edge(u, v, capacity);
-    //    Edge* e_res = new Edge(v, u, 0);
-    e->flow = 0;
-    // e->residual = e_res;
-    // e_res->residual = e;
-    adj[u][v] = e;
+    FlowReduction<Cap> reduction;
+    typename FlowReduction<Cap>::Reduced R(1);
+    R.algorithm = G.algorithm;
+    R.capacity_scaling = G.capacity_scaling;
+    R.threads = G.threads;
+    reduction.reduce(G, source, sink, R);
+    cerr << "reduced to " << R.n << " vertices and " << R.m << " edges: " << reduction.pruned << " vertices pruned, "
+         << reduction.contracted << " contracted, " << reduction.merged << " parallel edges merged" << endl;
+    long long a;
+    if (o.value_only)
+    {
+        a = R.min_cut_value(reduction.source, reduction.sink);
+    }
+    else
+    {
+        a = R.max_flow(reduction.source, reduction.sink);
+        reduction.expand_flow(R, G);
+        cut = reduction.min_cut(G, source);
+    }
+    double load_us = G.stats.load_us;
+    G.stats = R.stats;
+    G.stats.load_us = load_us;
+    return a;
 }
- /**
-     * @brief Finds an augmenting path in the residual graph using DFS.
-     * 
-     * @param vv An augPathObj object containing the source and sink vertices.
-     * @return A vector of ResidualEdge pointers representing the augmenting path.
-     */
-void Graph::create_residual_graph()
+
+// hands the flow of every edge, the cut edges and the cut sides to the export thread
+template <class Cap>
+static void export_flow(ResultWriter &writer, const BasicGraph<Cap> &G, int source, int sink, long long value,
+                        const CutResult &cut, bool with_edges)
 {
-    for (int u = 0; u < n; u++)
+    writer.begin(RESULT_FLOW, G.n, source, sink, value, with_edges ? G.m : 0);
+    if (!with_edges)
     {
-        for (int v = 0; v < n; v++)
+        writer.end();
+        return;
+    }
+    vector<char> crossing(G.m, 0), sides(G.n, 0);
+    for (size_t i = 0; i < cut.edges.size(); i++)
+    {
+        crossing[cut.edges[i]] = 1;
+    }
+    vector<ResultRecord> batch;
+    for (int i = 0; i < G.m; i++)
+    {
+        ResultRecord r = {G.edges[i].u, G.edges[i].v, (int64_t)G.edges[i].capacity, (int64_t)G.edges[i].flow,
+                          crossing[i] ? RESULT_CUT : 0, 0};
+        batch.push_back(r);
+        if (batch.size() == 65536 || i == G.m - 1)
         {
-            if (adj[u][v])
-            {
-                // Create forward edge in residual graph only if c(e)-f(e) is non zero
-                if (adj[u][v]->capacity - adj[u][v]->flow > 0)
-                {
- 
-                    ResidualEdge *forward_edge = new ResidualEdge(u, v, adj[u][v]->capacity - adj[u][v]->flow, adj[u].size() - 1, residual_adj[v].size());
-                    residual_adj[u][v] = forward_edge;
-                }
-                else if (adj[u][v]->capacity - adj[u][v]->flow == 0)
-                {
-                    residual_adj[u][v] = nullptr;
-                }
- 
-                // Create backward edge in residual graph only if the flow in the backward edge is non zero
-                if (adj[u][v]->flow != 0)
-                {
-                    ResidualEdge *backward_edge = new ResidualEdge(v, u, adj[u][v]->flow, residual_adj[v].size(), adj[u].size() - 1);
-                    residual_adj[v][u] = backward_edge;
-                }
-                else
-                {
-                    residual_adj[v][u] = nullptr;
-                }
- 
-                // Set pointers to residual edges
-                // forward_edge->residual = backward_edge;
-                // backward_edge->residual = forward_edge;
-            }
+            writer.add_edges(batch);
+            batch.clear();
         }
     }
+    for (size_t i = 0; i < cut.source_side.size(); i++)
+    {
+        sides[cut.source_side[i]] = 1;
+    }
+    writer.add_sides(sides);
+    writer.end();
 }
-/**
-     * @brief Performs a depth-first search (DFS) to find an augmenting path in the residual graph.
-     * 
-     * @param s The current vertex being visited.
-     * @param t The sink vertex.
-     * @param parent A vector of ResidualEdge pointers representing the parent of each vertex in the DFS tree.
-     * @param visited A vector of booleans representing whether each vertex has been visited or not.
-     * @return true if an augmenting path is found, false otherwise.
-     */
-bool Graph::dfs(int s, int t, vector<ResidualEdge *> &parent, vector<bool> &visited)
+
+// loads and solves the input on a graph with capacities of type Cap
+template <class Cap>
+static int run(const Options &o)
 {
-    // Mark the current vertex as visited
-    visited[s] = true;
- 
-    // If s is the sink, return true
-    if (s == t)
+    const string &input = o.input;
+    // the printed execution time runs from before the load to after the cut is printed
+    auto start_time = Clock::now();
+
+    BasicGraph<Cap> G(1);
+    G.algorithm = o.algorithm;
+    G.capacity_scaling = o.scaling;
+    if (o.threads > 0)
+    {
+        G.threads = o.threads;
+    }
+    int source, sink;
+    string error;
+    if (!load_graph(input, G, source, sink, error))
     {
-        return true;
+        cerr << error << endl;
+        return 1;
     }
- 
-    // Loop through all adjacent vertices of s in the residual graph
-    for (int v = 0; v < n; v++)
+    if (!o.snapshot.empty())
     {
-        // If v is not visited and has positive residual capacity
-        if (!visited[v] && residual_adj[s][v] != nullptr)
+        if (o.snapshot_flow)
         {
-            // Set v as the parent of s
-            parent[v] = new ResidualEdge(s, v, residual_adj[s][v]->capacity, 0, 0);
- 
-            // Recursively do DFS from v to t
-            if (dfs(v, t, parent, visited))
-            {
-                return true;
-            }
+            G.max_flow(source, sink);
         }
+        if (!G.write_snapshot(o.snapshot, source, sink, o.snapshot_flow, error))
+        {
+            cerr << error << endl;
+            return 1;
+        }
+        return 0;
     }
- 
-    // If no augmenting path is found from s, return false
-    return false;
-}
-/**
-     * @brief Finds an augmenting path in the residual graph using DFS.
-     * 
-     * @param vv An augPathObj object containing the source and sink vertices.
-     * @return A vector of ResidualEdge pointers representing the augmenting path.
-     */
-vector<ResidualEdge *> Graph::find_augmenting_path(int source, int sink)
-{
-    vector<bool> visited(n, false);
-    vector<ResidualEdge *> parent(n, nullptr);
- 
-    if (!dfs(source, sink, parent, visited))
+    if (!o.pairs_path.empty())
     {
-        for (int i = 0; i < n; i++)
+        return answer_pairs(G, o);
+    }
+    long long a, cost = 0;
+    CutResult cut; // left empty by --value-only
+    if (!o.min_cost.empty())
+    {
+        G.cost_algorithm = o.min_cost == "scaling" ? COST_SCALING : SUCCESSIVE_SHORTEST_PATHS;
+        a = G.min_cost_flow(source, sink, cost);
+        if (a < 0)
         {
-            parent[i] = nullptr;
+            cerr << input << ": negative cost cycle, use --min-cost scaling" << endl;
+            return 1;
         }
+        cut = G.min_cut(source, sink);
     }
-    return parent;
-}
-/**
-     * @brief Calculates the maximum flow in the graph using the Ford-Fulkerson algorithm.
-     * 
-     * @param mm A maxFlowObj object containing the source and sink vertices.
-     * @return The maximum flow in the graph.
-     */
-int Graph::max_flow(int source, int sink)
-{
-    int max_flow = 0;
-    while (true)
+    else if (o.reduce)
+    {
+        a = solve_reduced(G, source, sink, o, cut);
+    }
+    else if (o.value_only)
     {
-        // cout << 0 << "//////" << endl;
-        create_residual_graph();
-        // for (int i = 0; i < residual_adj.size(); i++)
-        // {
-        //     for (int j = 0; j < residual_adj[i].size(); j++)
-        //     {
-        //         if (residual_adj[i][j] != nullptr)
-        //             cout << residual_adj[i][j]->u << " " << residual_adj[i][j]->v << " " << residual_adj[i][j]->capacity << endl;
-        //     }
-        // }
-        // cout << endl;
-        vector<ResidualEdge *> augmenting_path = find_augmenting_path(source, sink);
-        // for (int v = sink; v != source; v = augmenting_path[v]->u)
-        // {
-        //     cout << augmenting_path[v]->u << " ";
-        // }
-        // cout << endl;
-        if (!augmenting_path[sink])
+        a = G.min_cut_value(source, sink);
+    }
+    else
+    {
+        a = G.max_flow(source, sink);
+        cut = G.min_cut(source, sink);
+    }
+
+    // the result goes to the writer thread before the clock stops, so formatting and writing it
+    // overlap with the printing below and only the hand-over is timed
+    ResultWriter writer;
+    if (o.export_path != "none")
+    {
+        if (!writer.open(o.export_path, export_format_of(o.export_path), error))
         {
-            break;
+            cerr << error << endl;
+            return 1;
         }
- 
-        int path_flow = INT_MAX;
-        for (int v = sink; v != source; v = augmenting_path[v]->u)
+        export_flow(writer, G, source, sink, a, cut, !o.value_only);
+    }
+
+    if (!o.value_only)
+    {
+        cout<<"st-cut: \n";
+        for (int i = 0; i < (int)cut.edges.size(); i++)
         {
-            path_flow = min(path_flow, augmenting_path[v]->capacity); // finding the bottleneck capacity
+            cout << G.edges[cut.edges[i]].u << " " << G.edges[cut.edges[i]].v << endl;
         }
-        // for the particular augmented edge selected we change the flow of the edges in the acutal graph.
-        // for (int v = sink; v != source; v = augmenting_path[v]->u)
-        // {
-        //     cout << augmenting_path[v]->u << " " << augmenting_path[v]->v << " " << augmenting_path[v]->capacity << endl;
-        // }
-        // cout << path_flow << endl;
-        for (int v = sink; v != source; v = augmenting_path[v]->u)
+    }
+    long long elapsed_ns = chrono::duration_cast<chrono::nanoseconds>(Clock::now() - start_time).count();
+
+    cout << "max flow is :- "<< a << endl;
+    if (!o.min_cost.empty())
+    {
+        cout << "min cost is :- " << cost << endl;
+    }
+    cout << "Execution time: " << elapsed_ns / 1000 << " microseconds" << endl;
+
+    if (!o.paths_path.empty())
+    {
+        ofstream file;
+        if (o.paths_path != "-")
         {
-            if (!adj[augmenting_path[v]->u][v])
+            file.open(o.paths_path.c_str());
+            if (!file.is_open())
             {
-                adj[v][augmenting_path[v]->u]->flow -= path_flow;
+                cerr << o.paths_path << ": " << strerror(errno) << endl;
+                return 1;
             }
-            else
-                adj[augmenting_path[v]->u][v]->flow += path_flow;
         }
-        // for (int v = sink; v != source; v = augmenting_path[v]->u)
-        // {
-        //     ResidualEdge *forward_edge = augmenting_path[v];
-        //     ResidualEdge *backward_edge = residual_adj[v][forward_edge->u];
- 
-        //     forward_edge->capacity -= path_flow;
-        //     if (backward_edge)
-        //     {
-        //         backward_edge->capacity += path_flow;
-        //     }
-        //     else
-        //     {
-        //         ResidualEdge *new_backward_edge = new ResidualEdge(v, forward_edge->u, path_flow, residual_adj[v].size(), forward_edge->forward_edge_idx);
-        //         residual_adj[v][forward_edge->u] = new_backward_edge;
-        //     }
- 
-        //     adj[forward_edge->u][forward_edge->v]->flow += path_flow;
-        // }
-        max_flow += path_flow;
+        PathPrinter<Cap> printer(G, o.paths_path == "-" ? cout : file);
+        G.decompose_flow(source, sink, printer);
     }
- 
-    return max_flow;
-}
- /*
-    * @brief Calculates the minimum cut of the graph using the Ford-Fulkerson algorithm.
-    *
-    * @param bb A pointer to a stCutObj object representing the source and sink nodes of the graph.
-    * @return A vector of pairs representing the edges that cross the minimum cut.
-    */
-vector<pair<int, int>> Graph::st_cut(int source, int sink) {
-    // Run the Ford-Fulkerson algorithm to find the max flow
-    max_flow(source, sink);
- 
-    // Perform a DFS on the residual graph to find the set of vertices reachable from the source
-    vector<bool> visited(n, false);
-    dfs_cut(source, sink, visited);
- 
-    // Find the edges crossing the cut (from the visited set to the unvisited set)
-    vector<pair<int, int>> cut_edges;
-    for (int u = 0; u < n; u++) {
-        if (visited[u]) {
-            for (int v = 0; v < n; v++) {
-                if (!visited[v] && adj[u][v]) {
-                    cut_edges.push_back(make_pair(u, v));
-                }
+
+    if (!o.stats_path.empty())
+    {
+        string name;
+        for (size_t i = 0; i < input.size(); i++)
+        {
+            if (input[i] == '"' || input[i] == '\\')
+            {
+                name += '\\';
             }
+            name += input[i];
         }
-    }
- 
-    return cut_edges;
-}
- 
-// Helper method to perform DFS on the residual graph
-void Graph::dfs_cut(int u, int sink, vector<bool> &visited) {
-    visited[u] = true;
- 
-    for (int v = 0; v < n; v++) {
-        if (!visited[v] && residual_adj[u][v] && residual_adj[u][v]->capacity > 0) {
-            dfs_cut(v, sink, visited);
+        string json = "{\"input\": \"" + name + "\", \"vertices\": " + to_string(G.n) + ", \"edges\": " + to_string(G.m) +
+                      ", \"flow\": " + to_string(a) + ", \"stats\": " + G.stats.to_json() + "}";
+        if (o.stats_path == "-")
+        {
+            cout << json << endl;
         }
+        else
+        {
+            ofstream out(o.stats_path.c_str());
+            if (!out.is_open())
+            {
+                cerr << o.stats_path << ": " << strerror(errno) << endl;
+                return 1;
+            }
+            out << json << endl;
+        }
+    }
+    if (!writer.finish(error))
+    {
+        cerr << error << endl;
+        return 1;
     }
+    return 0;
 }
- 
- 
-int main()
+
+int main(int argc, char **argv)
 {
-    ifstream infile("inputTask1.txt");
-    // Start measuring time
-    // time_t begin, end;
-    // time(&begin);
-    // cout<<"ran";
-    auto start_time = Clock::now();
-    
-    int n;
-    infile >> n; // number of vertices
- 
-    Graph G(n);
-    int source, sink;
-    infile >> source >> sink;
- 
-    int u, v, capacity;
-    while (infile >> u >> v >> capacity)
+    Options o;
+    o.algorithm = FORD_FULKERSON;
+    o.threads = 0;
+    o.scaling = false;
+    o.value_only = false;
+    o.input = "inputTask1.txt";
+    o.snapshot_flow = false;
+    o.capacity = "int";
+    o.reduce = false;
+    o.export_path = "resultTask1.json";
+    for (int i = 1; i < argc; i++)
     {
-        // cout << u << " " << v << " " << capacity << endl;
-        G.add_edge(u, v, capacity);
+        string arg = argv[i];
+        if (arg == "--algo" && i + 1 < argc)
+        {
+            string name = argv[++i];
+            if (name == "ff")
+            {
+                o.algorithm = FORD_FULKERSON;
+            }
+            else if (name == "ek")
+            {
+                o.algorithm = EDMONDS_KARP;
+            }
+            else if (name == "dinic")
+            {
+                o.algorithm = DINIC;
+            }
+            else if (name == "hlpp")
+            {
+                o.algorithm = PUSH_RELABEL;
+            }
+            else if (name == "parallel")
+            {
+                o.algorithm = PARALLEL_PUSH_RELABEL;
+            }
+            else
+            {
+                cerr << "unknown algorithm " << name << ", expected ff, ek, dinic, hlpp or parallel" << endl;
+                return 1;
+            }
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            o.threads = atoi(argv[++i]);
+        }
+        else if (arg == "--scaling")
+        {
+            o.scaling = true;
+        }
+        else if (arg == "--value-only")
+        {
+            o.value_only = true;
+        }
+        else if (arg == "--convert" && i + 1 < argc)
+        {
+            o.snapshot = argv[++i];
+        }
+        else if (arg == "--stats" && i + 1 < argc)
+        {
+            o.stats_path = argv[++i];
+        }
+        else if (arg == "--cut-tree" && i + 1 < argc)
+        {
+            o.pairs_path = argv[++i];
+        }
+        else if (arg == "--capacity" && i + 1 < argc)
+        {
+            o.capacity = argv[++i];
+        }
+        else if (arg == "--reduce")
+        {
+            o.reduce = true;
+        }
+        else if (arg == "--export" && i + 1 < argc)
+        {
+            o.export_path = argv[++i];
+        }
+        else if (arg == "--paths" && i + 1 < argc)
+        {
+            o.paths_path = argv[++i];
+        }
+        else if (arg == "--min-cost" && i + 1 < argc)
+        {
+            o.min_cost = argv[++i];
+        }
+        else if (arg == "--with-flow")
+        {
+            o.snapshot_flow = true;
+        }
+        else if (arg[0] != '-')
+        {
+            o.input = arg;
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--algo ff|ek|dinic|hlpp|parallel] [--threads k] [--scaling] [--value-only] [--convert snapshot [--with-flow]] [--stats file|-] [--cut-tree pairs] [--capacity int|int64|unit] [--reduce] [--export file.json|file.dot|file.bin|none] [--paths file|-] [--min-cost ssp|scaling] [input]" << endl;
+            cerr << "input is a text edge list, a --convert snapshot or a binary edge list from generateTask1 --binary (int capacities only)" << endl;
+            return 1;
+        }
     }
-    // G.create_residual_graph();
-    // vector<ResidualEdge*> ans = G.find_augmenting_path(2,4);
-    // (!ans[4])?cout << 1 << endl:cout << 0 << endl;
-    // for(int v = 2;v != 4;v = ans[v]->u){
-    //     cout << ans[v]->u << " " << ans[v]->v << endl;
-    // }
-    int a = G.max_flow(source, sink);
-    vector<pair<int,int>> st_cut_edges = G.st_cut(source,sink);
-    cout<<"st-cut: \n";
-    for(int i = 0;i < st_cut_edges.size();i++){
-        cout << st_cut_edges[i].first << " " << st_cut_edges[i].second << endl;
-    } 
 
-
-
-    // // Start measuring time
-    // auto begin = chrono::high_resolution_clock::now();
-    
-   
-    
-    // // Stop measuring time and calculate the elapsed time
-    // auto end = std::chrono::high_resolution_clock::now();
-    // auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin);
-    
-    auto end_time = Clock::now();
-    auto bholu = chrono::duration_cast<chrono::nanoseconds>(end_time    - start_time).count();
-    
-    
-    // printf("Time measured: %.3f seconds.\n", elapsed.count() * 1e-9);
-
-    cout << "max flow is :- "<< a << endl;
-    cout << "Execution time: " <<  bholu/1000<< " microseconds" << endl;
-
-
-    string filename = "plotterTask1.py";
-    string command = "python ";
-    command += filename;
-    system(command.c_str());
-    return 0;
+    if (o.value_only && !o.paths_path.empty())
+    {
+        cerr << "--paths needs the flow, which --value-only does not compute" << endl;
+        return 1;
+    }
+    if (!o.min_cost.empty() && o.min_cost != "ssp" && o.min_cost != "scaling")
+    {
+        cerr << "unknown min-cost engine " << o.min_cost << ", expected ssp or scaling" << endl;
+        return 1;
+    }
+    if (!o.min_cost.empty() && (o.value_only || o.reduce))
+    {
+        cerr << "--min-cost solves the whole graph with its flow, it does not combine with --value-only or --reduce" << endl;
+        return 1;
+    }
+    if (o.capacity == "int")
+    {
+        return run<int>(o);
+    }
+    if (o.capacity == "int64")
+    {
+        return run<long long>(o);
+    }
+    if (o.capacity == "unit")
+    {
+        return run<bool>(o);
+    }
+    cerr << "unknown capacity type " << o.capacity << ", expected int, int64 or unit" << endl;
+    return 1;
 }
\ No newline at end of file
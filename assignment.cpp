@@ -0,0 +1,447 @@
+#include "assignment.h"
+#include <climits>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+WeightedAssignment::WeightedAssignment(int n)
+{
+    this->n = n;
+    threads = max(1u, thread::hardware_concurrency());
+    rounds = 0;
+}
+
+void WeightedAssignment::add_edge(int u, int v, long long weight)
+{
+    edge_list.push_back(make_pair(u, v));
+    edge_weight.push_back(weight);
+}
+
+long long WeightedAssignment::solve(AssignmentMethod method)
+{
+    if (method == ASSIGN_HUNGARIAN || (method == ASSIGN_AUTO && prefers_hungarian()))
+    {
+        return hungarian();
+    }
+    return auction();
+}
+
+bool WeightedAssignment::prefers_hungarian() const
+{
+    // the matrix engine does n^3 simple steps no matter how few edges there are
+    return n <= 64 || (n <= 1500 && (long long)edge_list.size() * 4 >= (long long)n * n);
+}
+
+// bidders per thread below which a Jacobi round is not worth splitting
+const int PARALLEL_BIDDERS = 4096;
+
+long long WeightedAssignment::auction()
+{
+    // only the heaviest of parallel edges counts, and only if it is positive
+    vector<pair<pair<int, int>, long long>> edges;
+    for (int i = 0; i < (int)edge_list.size(); i++)
+    {
+        if (edge_weight[i] > 0)
+        {
+            edges.push_back(make_pair(edge_list[i], -edge_weight[i]));
+        }
+    }
+    sort(edges.begin(), edges.end());
+    int k = 0;
+    for (int i = 0; i < (int)edges.size(); i++)
+    {
+        if (k == 0 || edges[i].first != edges[k - 1].first)
+        {
+            edges[k++] = edges[i];
+        }
+    }
+    edges.resize(k);
+
+    // persons 0 .. n - 1 are the left vertices, n + v the copy of right vertex v;
+    // objects 0 .. n - 1 are the right vertices, n + u the "unmatched" object of left vertex u
+    int N = 2 * n;
+    long long scale = N + 1;
+    vector<int> first(N + 1, 0);
+    for (int i = 0; i < k; i++)
+    {
+        first[edges[i].first.first + 1]++;
+        first[n + edges[i].first.second + 1]++;
+    }
+    for (int p = 0; p < N; p++)
+    {
+        first[p + 1] += first[p] + 1;
+    }
+    vector<int> object(first[N]);
+    vector<long long> value(first[N], 0);
+    vector<int> pos(first.begin(), first.end() - 1);
+    for (int i = 0; i < k; i++)
+    {
+        int u = edges[i].first.first, v = edges[i].first.second;
+        object[pos[u]] = v;
+        value[pos[u]++] = -edges[i].second * scale;
+        object[pos[n + v]++] = n + u;
+    }
+    long long largest = 0;
+    for (int p = 0; p < N; p++)
+    {
+        object[pos[p]] = p < n ? n + p : p - n;
+    }
+    for (int i = 0; i < k; i++)
+    {
+        largest = max(largest, -edges[i].second * scale);
+    }
+
+    match_left.assign(n, -1);
+    match_right.assign(n, -1);
+    rounds = 0;
+    if (largest == 0)
+    {
+        return 0;
+    }
+
+    vector<long long> price(N, 0), bid_price(N), best_bid(N);
+    vector<int> owner(N), assigned(N), bid_object(N), best_bidder(N, -1);
+    vector<int> bidders, next, touched;
+
+    // person p names its best object j and a price within eps of its second best
+    long long eps = largest;
+    auto bid_of = [&](int p, int &j, long long &offer)
+    {
+        long long best = LLONG_MIN, second = LLONG_MIN;
+        j = -1;
+        // bidders start their scans at different arcs, so ties send them to different objects
+        int degree = first[p + 1] - first[p], start = (p + rounds) % degree;
+        for (int k = 0; k < degree; k++)
+        {
+            int a = first[p] + (start + k < degree ? start + k : start + k - degree);
+            long long profit = value[a] - price[object[a]];
+            if (profit > best)
+            {
+                second = best;
+                best = profit;
+                j = object[a];
+            }
+            else if (profit > second)
+            {
+                second = profit;
+            }
+        }
+        // an object nobody else can take is worth any price up to the largest value
+        offer = price[j] + (second == LLONG_MIN ? largest : best - second) + eps;
+    };
+    auto bid = [&](int lo, int hi)
+    {
+        for (int i = lo; i < hi; i++)
+        {
+            bid_of(bidders[i], bid_object[i], bid_price[i]);
+        }
+    };
+
+    // the bidding threads live as long as the auction and wait for a new round between rounds
+    mutex round_lock;
+    condition_variable round_start, round_done;
+    long long generation = 0;
+    int round_size = 0, round_workers = 0, busy = 0;
+    bool stopping = false;
+    vector<thread> pool;
+    for (int t = 1; t < min(threads, N / PARALLEL_BIDDERS); t++)
+    {
+        pool.push_back(thread([&, t]()
+        {
+            for (long long seen = 0;;)
+            {
+                {
+                    unique_lock<mutex> guard(round_lock);
+                    round_start.wait(guard, [&] { return stopping || generation != seen; });
+                    if (stopping)
+                    {
+                        return;
+                    }
+                    seen = generation;
+                }
+                if (t < round_workers)
+                {
+                    bid((long long)round_size * t / round_workers, (long long)round_size * (t + 1) / round_workers);
+                }
+                lock_guard<mutex> guard(round_lock);
+                if (--busy == 0)
+                {
+                    round_done.notify_one();
+                }
+            }
+        }));
+    }
+
+    while (eps > 1)
+    {
+        eps = max(1LL, eps / 8);
+        fill(owner.begin(), owner.end(), -1);
+        fill(assigned.begin(), assigned.end(), -1);
+        bidders.resize(N);
+        for (int p = 0; p < N; p++)
+        {
+            bidders[p] = p;
+        }
+        // Jacobi rounds while the bids are worth splitting over the threads
+        while (!bidders.empty())
+        {
+            int size = bidders.size();
+            int workers = min((int)pool.size() + 1, size / PARALLEL_BIDDERS);
+            if (workers <= 1)
+            {
+                break;
+            }
+            rounds++;
+            {
+                lock_guard<mutex> guard(round_lock);
+                round_size = size;
+                round_workers = workers;
+                busy = pool.size();
+                generation++;
+            }
+            round_start.notify_all();
+            bid(0, size / workers);
+            {
+                unique_lock<mutex> guard(round_lock);
+                round_done.wait(guard, [&] { return busy == 0; });
+            }
+
+            // the highest bid wins, ties go to the bidder listed first
+            touched.clear();
+            for (int i = 0; i < size; i++)
+            {
+                int j = bid_object[i];
+                if (best_bidder[j] < 0)
+                {
+                    touched.push_back(j);
+                }
+                else if (bid_price[i] <= best_bid[j])
+                {
+                    continue;
+                }
+                best_bidder[j] = bidders[i];
+                best_bid[j] = bid_price[i];
+            }
+            next.clear();
+            for (int i = 0; i < size; i++)
+            {
+                if (best_bidder[bid_object[i]] != bidders[i])
+                {
+                    next.push_back(bidders[i]);
+                }
+            }
+            for (int t = 0; t < (int)touched.size(); t++)
+            {
+                int j = touched[t];
+                if (owner[j] >= 0)
+                {
+                    assigned[owner[j]] = -1;
+                    next.push_back(owner[j]);
+                }
+                owner[j] = best_bidder[j];
+                assigned[owner[j]] = j;
+                price[j] = best_bid[j];
+                best_bidder[j] = -1;
+            }
+            bidders.swap(next);
+        }
+
+        // then one bidder at a time takes its object at once and evicts the owner (Gauss-Seidel),
+        // which ends the long tail of rounds with a handful of bidders each
+        while (!bidders.empty())
+        {
+            int p = bidders.back(), j;
+            bidders.pop_back();
+            rounds++;
+            long long offer;
+            bid_of(p, j, offer);
+            if (owner[j] >= 0)
+            {
+                assigned[owner[j]] = -1;
+                bidders.push_back(owner[j]);
+            }
+            owner[j] = p;
+            assigned[p] = j;
+            price[j] = offer;
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(round_lock);
+        stopping = true;
+    }
+    round_start.notify_all();
+    for (int t = 0; t < (int)pool.size(); t++)
+    {
+        pool[t].join();
+    }
+
+    for (int u = 0; u < n; u++)
+    {
+        if (assigned[u] < n)
+        {
+            match_left[u] = assigned[u];
+            match_right[assigned[u]] = u;
+        }
+    }
+    return matching_weight();
+}
+
+long long WeightedAssignment::hungarian()
+{
+    // weights of the n x n matrix, a missing or non-positive edge is as good as no match
+    vector<long long> weight((long long)n * n, 0);
+    for (int i = 0; i < (int)edge_list.size(); i++)
+    {
+        long long &w = weight[(long long)edge_list[i].first * n + edge_list[i].second];
+        w = max(w, edge_weight[i]);
+    }
+
+    // rows and columns are 1-based, column 0 holds the row being added; the costs are -weight
+    vector<long long> row_potential(n + 1, 0), column_potential(n + 1, 0), slack(n + 1);
+    vector<int> row_of(n + 1, 0), way(n + 1, 0);
+    vector<char> used(n + 1);
+    for (int i = 1; i <= n; i++)
+    {
+        row_of[0] = i;
+        int column = 0;
+        fill(slack.begin(), slack.end(), LLONG_MAX);
+        fill(used.begin(), used.end(), 0);
+        // grow a shortest path tree from row i until it reaches a free column
+        do
+        {
+            used[column] = 1;
+            int row = row_of[column], next = 0;
+            long long delta = LLONG_MAX;
+            const long long *costs = &weight[(long long)(row - 1) * n];
+            for (int j = 1; j <= n; j++)
+            {
+                if (!used[j])
+                {
+                    long long reduced = -costs[j - 1] - row_potential[row] - column_potential[j];
+                    if (reduced < slack[j])
+                    {
+                        slack[j] = reduced;
+                        way[j] = column;
+                    }
+                    if (slack[j] < delta)
+                    {
+                        delta = slack[j];
+                        next = j;
+                    }
+                }
+            }
+            for (int j = 0; j <= n; j++)
+            {
+                if (used[j])
+                {
+                    row_potential[row_of[j]] += delta;
+                    column_potential[j] -= delta;
+                }
+                else
+                {
+                    slack[j] -= delta;
+                }
+            }
+            column = next;
+        } while (row_of[column] != 0);
+        // flip the path back to column 0
+        do
+        {
+            int previous = way[column];
+            row_of[column] = row_of[previous];
+            column = previous;
+        } while (column != 0);
+    }
+
+    match_left.assign(n, -1);
+    match_right.assign(n, -1);
+    for (int j = 1; j <= n; j++)
+    {
+        int u = row_of[j] - 1;
+        if (weight[(long long)u * n + j - 1] > 0)
+        {
+            match_left[u] = j - 1;
+            match_right[j - 1] = u;
+        }
+    }
+    return matching_weight();
+}
+
+vector<pair<int, int>> WeightedAssignment::matched_pairs()
+{
+    vector<pair<int, int>> pairs;
+    for (int u = 0; u < n; u++)
+    {
+        if (match_left[u] >= 0)
+        {
+            pairs.push_back(make_pair(u, match_left[u]));
+        }
+    }
+    return pairs;
+}
+
+long long WeightedAssignment::matching_weight() const
+{
+    vector<long long> best(n, LLONG_MIN);
+    for (int i = 0; i < (int)edge_list.size(); i++)
+    {
+        int u = edge_list[i].first;
+        if (match_left[u] == edge_list[i].second)
+        {
+            best[u] = max(best[u], edge_weight[i]);
+        }
+    }
+    long long total = 0;
+    for (int u = 0; u < n; u++)
+    {
+        if (match_left[u] >= 0)
+        {
+            total += best[u];
+        }
+    }
+    return total;
+}
+
+bool load_weighted_bipartite(const string &path, WeightedAssignment &G, string &error)
+{
+    ifstream infile(path.c_str());
+    int n;
+    if (!(infile >> n) || n < 0)
+    {
+        error = path + ": expected the vertex count";
+        return false;
+    }
+    G = WeightedAssignment(n);
+    string line, rest;
+    getline(infile, line);
+    for (int number = 2; getline(infile, line); number++)
+    {
+        if (line.find_first_not_of(" \t\r") == string::npos)
+        {
+            continue;
+        }
+        istringstream in(line);
+        long long u, v, weight;
+        if (!(in >> u >> v >> weight) || (in >> rest))
+        {
+            error = path + ":" + to_string(number) + ": expected 'u v weight'";
+            return false;
+        }
+        if (u < 0 || u >= n || v < 0 || v >= n)
+        {
+            error = path + ":" + to_string(number) + ": vertex out of range";
+            return false;
+        }
+        if (weight < INT_MIN || weight > INT_MAX)
+        {
+            error = path + ":" + to_string(number) + ": weight " + to_string(weight) + " does not fit in an int";
+            return false;
+        }
+        G.add_edge(u, v, weight);
+    }
+    return true;
+}
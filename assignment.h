@@ -0,0 +1,102 @@
+#ifndef ASSIGNMENT_H
+#define ASSIGNMENT_H
+
+#include <vector>
+#include <string>
+using namespace std;
+
+/**
+ * @brief The assignment engines that WeightedAssignment::solve can run.
+ */
+enum AssignmentMethod
+{
+    ASSIGN_AUTO,     // HUNGARIAN for small dense graphs, AUCTION otherwise
+    ASSIGN_AUCTION,  // eps-scaling auction, bids of the unassigned left vertices computed in parallel
+    ASSIGN_HUNGARIAN // shortest augmenting paths on the dense weight matrix, O(n^3)
+};
+
+/**
+ * @brief Bipartite graph with edge weights, solved for a matching of largest total weight.
+ *
+ * As in BipartiteGraph, left and right vertices live in separate id spaces [0, n). A left
+ * vertex may stay unmatched, so edges of weight 0 or less are never needed and a matching
+ * of maximum weight is not always one of maximum size. Adding the same large constant to
+ * every weight makes every maximum weight matching a maximum size one as well.
+ */
+class WeightedAssignment
+{
+public:
+    int n;                             // number of vertex ids on each side
+    vector<pair<int, int>> edge_list;  // (left, right) pairs in the order they were added
+    vector<long long> edge_weight;
+    int threads;                       // bidding threads of the auction, the hardware concurrency by default
+
+    vector<int> match_left;  // right partner of every left vertex, -1 if unmatched
+    vector<int> match_right; // left partner of every right vertex, -1 if unmatched
+    long long rounds;        // Jacobi rounds plus single Gauss-Seidel bids of the last auction
+
+    // constructor to initialize the graph
+    WeightedAssignment(int n);
+
+    // method to add an edge between left vertex u and right vertex v
+    void add_edge(int u, int v, long long weight);
+
+    /**
+     * @brief Calculates a matching of maximum total weight.
+     *
+     * @param method The engine, ASSIGN_AUTO picks one from the size and density of the graph.
+     * @return The total weight of the matching, left in match_left and match_right.
+     */
+    long long solve(AssignmentMethod method = ASSIGN_AUTO);
+
+    /**
+     * @brief Calculates a matching of maximum total weight with Bertsekas' auction algorithm.
+     *
+     * The matching problem becomes a perfect assignment on 2n persons and 2n objects: left
+     * vertex u may also take a private object of value 0 standing for "unmatched", and a
+     * copy of every right vertex v takes v when no left vertex does, or the private object
+     * of some neighbour u of v that took v. Weights are multiplied by 2n + 1, so an
+     * assignment within eps = 1 of optimal is optimal. Every phase divides eps by 8, drops
+     * the assignment and keeps the prices. A bid names the most valuable object of a person and
+     * raises its price by the gap to the second best plus eps. While there are enough unassigned
+     * persons to split over `threads` threads, they all bid at once (Jacobi auction) on threads
+     * that live as long as the auction, and each object goes to its highest bidder. The few
+     * left after that bid one at a time and take their object at once (Gauss-Seidel), so the
+     * tail of a phase costs one bid per step instead of a whole round.
+     *
+     * @return The total weight of the matching.
+     */
+    long long auction();
+
+    /**
+     * @brief Calculates a matching of maximum total weight with the Hungarian method.
+     *
+     * Runs the shortest augmenting path form of Jonker and Volgenant on the n x n matrix of
+     * the positive weights, where a missing edge weighs 0. A row assigned to a 0 entry stays
+     * unmatched. O(n^3) time and n^2 memory.
+     *
+     * @return The total weight of the matching.
+     */
+    long long hungarian();
+
+    // method to tell if the graph is small and dense enough for the O(n^3) matrix engine
+    bool prefers_hungarian() const;
+
+    // method to list the matched (left, right) pairs
+    vector<pair<int, int>> matched_pairs();
+
+    // method to add up the weights of the matched pairs, the heaviest edge between each pair
+    long long matching_weight() const;
+};
+
+/**
+ * @brief Loads a weighted bipartite graph: n, then one `u v weight` edge per line.
+ *
+ * @param path The file to read.
+ * @param G Receives the graph.
+ * @param error Receives "path:line: message" on failure.
+ * @return true on success.
+ */
+bool load_weighted_bipartite(const string &path, WeightedAssignment &G, string &error);
+
+#endif
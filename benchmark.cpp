@@ -0,0 +1,687 @@
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <algorithm>
+#include <iomanip>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <cmath>
+#include <csignal>
+#include <thread>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "maxflow.h"
+#include "matching.h"
+#include "assignment.h"
+#include "graph_families.h"
+using namespace std;
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Summary of the repeated runs of one engine on one instance.
+ */
+struct BenchmarkResult
+{
+    string engine, family;
+    long long size;       // requested edge count
+    int n;                // vertices of the instance
+    long long m;          // edges of the instance
+    int repeats;          // measured runs, warm-up runs excluded
+    int threads;          // threads of the engine, 1 for the sequential ones
+    double load[2];       // median and p95 in microseconds
+    double solve[2];
+    double speedup;       // median solve of hlpp on the same instance over this one, 0 without it
+    double cut[2];
+    long long value;      // max flow, matching size or matching weight
+    long peak_rss_kb;     // peak resident set of the process that ran the engine
+    string status;        // ok, timeout, failed, skipped or mismatch
+};
+
+/**
+ * @brief Writes a generated instance and counts its vertices and edges on the way.
+ */
+struct CountingWriter
+{
+    TextEdgeWriter writer;
+    int n;
+    long long m;
+
+    CountingWriter(FILE *file) : writer(file), n(0), m(0) {}
+    void begin(int n, int source, int sink, long long expected)
+    {
+        this->n = n;
+        writer.begin(n, source, sink, expected);
+    }
+    void edge(int u, int v, int capacity)
+    {
+        m++;
+        writer.edge(u, v, capacity);
+    }
+    void end() { writer.end(); }
+};
+
+/**
+ * @brief Writes the pairs of the bipartite family with a seeded weight in [1, 1000] per edge.
+ */
+struct WeightedPairWriter
+{
+    FILE *file;
+    FamilyRandom random;
+
+    WeightedPairWriter(FILE *file, uint64_t seed) : file(file), random(seed) {}
+    void begin(int n, int, int, long long) { fprintf(file, "%d\n", n); }
+    void edge(int u, int v, int) { fprintf(file, "%d %d %d\n", u, v, random.between(1, 1000)); }
+    void end() {}
+};
+
+// engines the benchmark knows, the matching and assignment engines only run on the bipartite family
+const char *const ENGINE_NAMES[] = {"ff", "ek", "dinic", "hlpp", "parallel", "hk", "hk-dense", "auction", "hungarian"};
+const int ENGINE_COUNT = sizeof(ENGINE_NAMES) / sizeof(ENGINE_NAMES[0]);
+
+// the O(n^3) Hungarian engine is skipped above this many vertices per side, its matrix alone is n^2 weights
+const int HUNGARIAN_MAX_N = 2000;
+
+// tells if the engine solves the weighted pairs for a matching of largest weight
+bool is_assignment_engine(const string &engine)
+{
+    return engine == "auction" || engine == "hungarian";
+}
+
+// tells if the engine solves bipartite pairs instead of a flow network
+bool is_matching_engine(const string &engine)
+{
+    return engine == "hk" || engine == "hk-dense" || is_assignment_engine(engine);
+}
+
+// median and nearest-rank 95th percentile of the samples
+void summarize(vector<double> samples, double out[2])
+{
+    if (samples.empty())
+    {
+        out[0] = out[1] = 0;
+        return;
+    }
+    sort(samples.begin(), samples.end());
+    out[0] = samples.size() % 2 ? samples[samples.size() / 2]
+                                : (samples[samples.size() / 2 - 1] + samples[samples.size() / 2]) / 2;
+    size_t rank = (size_t)ceil(0.95 * samples.size());
+    out[1] = samples[max((size_t)1, rank) - 1];
+}
+
+double elapsed_us(Clock::time_point start, Clock::time_point end)
+{
+    return chrono::duration_cast<chrono::nanoseconds>(end - start).count() / 1000.0;
+}
+
+/**
+ * @brief Re-solves a solved graph for another pair and compares with a fresh solve of that pair.
+ *
+ * The flow left by the first pair is not conserved at its terminals, so a re-solve that
+ * started from it would return a wrong value; this guards the untimed path of every run.
+ *
+ * @return true if both solves agree, or the graph has no third vertex to pair with the sink.
+ */
+bool same_as_fresh_solve(Graph &G, const string &path, int source, int sink)
+{
+    int other = 0;
+    while (other == source || other == sink)
+    {
+        other++;
+    }
+    if (other >= G.n)
+    {
+        return true;
+    }
+    Graph F(1);
+    int s, t;
+    string error;
+    if (!load_graph(path, F, s, t, error))
+    {
+        return false;
+    }
+    F.algorithm = G.algorithm;
+    F.threads = G.threads;
+    long long again = G.max_flow(other, sink);
+    long long fresh = F.max_flow(other, sink);
+    if (again != fresh)
+    {
+        cerr << path << ": max flow " << other << " -> " << sink << " after solving " << source << " -> " << sink << " is "
+             << again << ", a fresh solve gives " << fresh << endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Runs one engine warmup + repeats times in the calling process and writes one
+ * `load solve cut value peak_rss_kb` line per measured run to fd.
+ */
+int run_engine(const string &engine, const string &path, int threads, int warmup, int repeats, int fd)
+{
+    FILE *out = fdopen(fd, "w");
+    for (int r = 0; r < warmup + repeats; r++)
+    {
+        string error;
+        long long value;
+        double times[3] = {0, 0, 0};
+        Graph G(1);
+        int source = 0, sink = 0;
+        if (engine == "hk" || engine == "hk-dense")
+        {
+            auto t0 = Clock::now();
+            BipartiteGraph B(0);
+            if (!load_bipartite(path, B, error))
+            {
+                cerr << error << endl;
+                return 1;
+            }
+            auto t1 = Clock::now();
+            value = engine == "hk" ? B.hopcroft_karp() : B.dense_matching();
+            auto t2 = Clock::now();
+            times[0] = elapsed_us(t0, t1);
+            times[1] = elapsed_us(t1, t2);
+        }
+        else if (is_assignment_engine(engine))
+        {
+            auto t0 = Clock::now();
+            WeightedAssignment W(0);
+            if (!load_weighted_bipartite(path, W, error))
+            {
+                cerr << error << endl;
+                return 1;
+            }
+            if (threads > 0)
+            {
+                W.threads = threads;
+            }
+            auto t1 = Clock::now();
+            value = engine == "auction" ? W.auction() : W.hungarian();
+            auto t2 = Clock::now();
+            times[0] = elapsed_us(t0, t1);
+            times[1] = elapsed_us(t1, t2);
+        }
+        else
+        {
+            auto t0 = Clock::now();
+            if (!load_graph(path, G, source, sink, error))
+            {
+                cerr << error << endl;
+                return 1;
+            }
+            if (engine == "ff")
+            {
+                G.algorithm = FORD_FULKERSON;
+            }
+            else if (engine == "ek")
+            {
+                G.algorithm = EDMONDS_KARP;
+            }
+            else if (engine == "dinic")
+            {
+                G.algorithm = DINIC;
+            }
+            else if (engine == "hlpp")
+            {
+                G.algorithm = PUSH_RELABEL;
+            }
+            else
+            {
+                G.algorithm = PARALLEL_PUSH_RELABEL;
+            }
+            if (threads > 0)
+            {
+                G.threads = threads;
+            }
+            auto t1 = Clock::now();
+            value = G.max_flow(source, sink);
+            auto t2 = Clock::now();
+            G.st_cut(source, sink);
+            auto t3 = Clock::now();
+            times[0] = elapsed_us(t0, t1);
+            times[1] = elapsed_us(t1, t2);
+            times[2] = elapsed_us(t2, t3);
+        }
+        if (r >= warmup)
+        {
+            struct rusage usage;
+            getrusage(RUSAGE_SELF, &usage);
+            fprintf(out, "%.3f %.3f %.3f %lld %ld\n", times[0], times[1], times[2], value, usage.ru_maxrss);
+            fflush(out);
+        }
+        // the check loads a second graph, so it runs after the peak RSS of the engine is recorded
+        if (!is_matching_engine(engine) && r == warmup + repeats - 1 && !same_as_fresh_solve(G, path, source, sink))
+        {
+            return 3;
+        }
+    }
+    fclose(out);
+    return 0;
+}
+
+/**
+ * @brief Measures one engine on one instance in a child process.
+ *
+ * The child gets its own address space, so its peak RSS belongs to this engine alone, and a
+ * run that exceeds the time limit is killed without taking the benchmark down with it. The
+ * peak RSS is the one the child reports after its measured runs, before its correctness check.
+ */
+void measure(BenchmarkResult &result, const string &path, int threads, int warmup, int repeats, int time_limit)
+{
+    int fds[2];
+    if (pipe(fds) < 0)
+    {
+        result.status = "failed";
+        return;
+    }
+    cout.flush();
+    pid_t pid = fork();
+    if (pid == 0)
+    {
+        close(fds[0]);
+        alarm(time_limit);
+        _exit(run_engine(result.engine, path, threads, warmup, repeats, fds[1]));
+    }
+    close(fds[1]);
+    vector<double> load, solve, cut;
+    result.value = -1;
+    FILE *in = fdopen(fds[0], "r");
+    double l, s, c;
+    long long value;
+    long rss;
+    result.peak_rss_kb = 0;
+    while (fscanf(in, "%lf %lf %lf %lld %ld", &l, &s, &c, &value, &rss) == 5)
+    {
+        load.push_back(l);
+        solve.push_back(s);
+        cut.push_back(c);
+        result.value = value;
+        result.peak_rss_kb = max(result.peak_rss_kb, rss);
+    }
+    fclose(in);
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    result.repeats = solve.size();
+    summarize(load, result.load);
+    summarize(solve, result.solve);
+    summarize(cut, result.cut);
+    if (WIFSIGNALED(status) && WTERMSIG(status) == SIGALRM)
+    {
+        result.status = "timeout";
+    }
+    else if (WIFEXITED(status) && WEXITSTATUS(status) == 3)
+    {
+        result.status = "mismatch";
+    }
+    else if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || (int)solve.size() != repeats)
+    {
+        result.status = "failed";
+    }
+    else
+    {
+        result.status = "ok";
+    }
+}
+
+// splits "a,b,c" into its parts
+vector<string> split_list(const string &list)
+{
+    vector<string> parts;
+    stringstream in(list);
+    string part;
+    while (getline(in, part, ','))
+    {
+        if (!part.empty())
+        {
+            parts.push_back(part);
+        }
+    }
+    return parts;
+}
+
+const char *const CSV_HEADER = "engine,family,size,n,m,repeats,threads,load_median_us,load_p95_us,solve_median_us,solve_p95_us,"
+                               "speedup,cut_median_us,cut_p95_us,value,peak_rss_kb,status";
+
+void write_csv(ostream &out, const vector<BenchmarkResult> &results)
+{
+    out << fixed << setprecision(1) << CSV_HEADER << "\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &r = results[i];
+        out << r.engine << "," << r.family << "," << r.size << "," << r.n << "," << r.m << "," << r.repeats << ","
+            << r.threads << "," << r.load[0] << "," << r.load[1] << "," << r.solve[0] << "," << r.solve[1] << ","
+            << setprecision(2) << r.speedup << setprecision(1) << "," << r.cut[0] << "," << r.cut[1] << "," << r.value << "," << r.peak_rss_kb << "," << r.status << "\n";
+    }
+}
+
+void write_json(ostream &out, const vector<BenchmarkResult> &results, uint64_t seed)
+{
+    out << fixed << setprecision(1) << "{\n  \"seed\": " << seed << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const BenchmarkResult &r = results[i];
+        out << "    {\"engine\": \"" << r.engine << "\", \"family\": \"" << r.family << "\", \"size\": " << r.size
+            << ", \"n\": " << r.n << ", \"m\": " << r.m << ", \"repeats\": " << r.repeats << ", \"threads\": " << r.threads
+            << ", \"load_us\": {\"median\": " << r.load[0] << ", \"p95\": " << r.load[1] << "}"
+            << ", \"solve_us\": {\"median\": " << r.solve[0] << ", \"p95\": " << r.solve[1] << "}"
+            << ", \"speedup\": " << setprecision(2) << r.speedup << setprecision(1)
+            << ", \"cut_us\": {\"median\": " << r.cut[0] << ", \"p95\": " << r.cut[1] << "}"
+            << ", \"value\": " << r.value << ", \"peak_rss_kb\": " << r.peak_rss_kb
+            << ", \"status\": \"" << r.status << "\"}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    out << "  ]\n}\n";
+}
+
+/**
+ * @brief Compares the median solve times against an earlier CSV run.
+ *
+ * @return The number of cases that got slower by more than the tolerance.
+ */
+int compare_baseline(const string &path, const vector<BenchmarkResult> &results, double tolerance)
+{
+    ifstream in(path.c_str());
+    string line;
+    if (!getline(in, line) || line != CSV_HEADER)
+    {
+        cerr << path << ": not a benchmark CSV" << endl;
+        return -1;
+    }
+    int regressions = 0;
+    while (getline(in, line))
+    {
+        vector<string> f;
+        stringstream fields(line);
+        string field;
+        while (getline(fields, field, ','))
+        {
+            f.push_back(field);
+        }
+        if (f.size() != 17 || f[16] != "ok")
+        {
+            continue;
+        }
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            const BenchmarkResult &r = results[i];
+            if (r.engine != f[0] || r.family != f[1] || to_string(r.size) != f[2] || to_string(r.threads) != f[6] ||
+                r.status != "ok")
+            {
+                continue;
+            }
+            double before = atof(f[9].c_str());
+            if (r.solve[0] > before * (1 + tolerance))
+            {
+                cerr << "regression: " << r.engine << " on " << r.family << " size " << r.size << " threads " << r.threads << ": median solve "
+                     << before << " us -> " << r.solve[0] << " us" << endl;
+                regressions++;
+            }
+        }
+    }
+    return regressions;
+}
+
+int main(int argc, char **argv)
+{
+    vector<string> engines(ENGINE_NAMES, ENGINE_NAMES + ENGINE_COUNT);
+    vector<string> families(FAMILY_NAMES, FAMILY_NAMES + FAMILY_COUNT);
+    vector<long long> sizes = {1000, 10000, 100000, 1000000};
+    uint64_t seed = 1;
+    vector<int> thread_counts(1, max(1u, thread::hardware_concurrency()));
+    int warmup = 1, repeats = 5, time_limit = 60;
+    string format = "csv", output, baseline, workdir = "/tmp";
+    bool snapshot = false;
+    double tolerance = 0.1;
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--engines" && i + 1 < argc)
+        {
+            engines = split_list(argv[++i]);
+        }
+        else if (arg == "--families" && i + 1 < argc)
+        {
+            families = split_list(argv[++i]);
+        }
+        else if (arg == "--sizes" && i + 1 < argc)
+        {
+            sizes.clear();
+            vector<string> parts = split_list(argv[++i]);
+            for (size_t j = 0; j < parts.size(); j++)
+            {
+                sizes.push_back(atoll(parts[j].c_str()));
+            }
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--warmup" && i + 1 < argc)
+        {
+            warmup = atoi(argv[++i]);
+        }
+        else if (arg == "--repeats" && i + 1 < argc)
+        {
+            repeats = max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            thread_counts.clear();
+            vector<string> parts = split_list(argv[++i]);
+            for (size_t j = 0; j < parts.size(); j++)
+            {
+                thread_counts.push_back(max(1, atoi(parts[j].c_str())));
+            }
+            if (thread_counts.empty())
+            {
+                thread_counts.push_back(1);
+            }
+        }
+        else if (arg == "--time-limit" && i + 1 < argc)
+        {
+            time_limit = max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--format" && i + 1 < argc)
+        {
+            format = argv[++i];
+        }
+        else if (arg == "--output" && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else if (arg == "--workdir" && i + 1 < argc)
+        {
+            workdir = argv[++i];
+        }
+        else if (arg == "--snapshot")
+        {
+            snapshot = true;
+        }
+        else if (arg == "--baseline" && i + 1 < argc)
+        {
+            baseline = argv[++i];
+        }
+        else if (arg == "--tolerance" && i + 1 < argc)
+        {
+            tolerance = atof(argv[++i]);
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--engines ff,ek,dinic,hlpp,parallel,hk,hk-dense,auction,hungarian] [--families "
+                 << "sparse,dense,layered,grid,powerlaw,bipartite,adversarial,ak] [--sizes 1000,10000,...] [--seed s] [--warmup k] "
+                 << "[--repeats k] [--threads 1,2,4,...] [--time-limit seconds] [--format csv|json] [--output file] "
+                 << "[--workdir dir] [--snapshot] [--baseline old.csv [--tolerance 0.1]]" << endl;
+            return 1;
+        }
+    }
+
+    vector<BenchmarkResult> results;
+    for (size_t f = 0; f < families.size(); f++)
+    {
+        // once an engine times out on a family the larger sizes are skipped, per thread count
+        vector<bool> gave_up(engines.size() * thread_counts.size(), false);
+        for (size_t s = 0; s < sizes.size(); s++)
+        {
+            string base = workdir + "/benchmark_" + families[f] + "_" + to_string(sizes[s]) + "_" + to_string(seed);
+            string path = base + ".txt";
+            FILE *file = fopen(path.c_str(), "w");
+            if (!file)
+            {
+                cerr << path << ": " << strerror(errno) << endl;
+                return 1;
+            }
+            CountingWriter count(file);
+            bool known = generate_family(families[f], sizes[s], seed, count);
+            fclose(file);
+            if (!known)
+            {
+                cerr << "unknown family " << families[f] << endl;
+                remove(path.c_str());
+                return 1;
+            }
+            if (snapshot)
+            {
+                Graph G(1);
+                int source, sink;
+                string error;
+                string text = path;
+                path = base + ".ffg";
+                if (!load_graph(text, G, source, sink, error) || !G.write_snapshot(path, source, sink, false, error))
+                {
+                    cerr << error << endl;
+                    return 1;
+                }
+                remove(text.c_str());
+            }
+            string pairs_path, weighted_path;
+            int pairs_n = 0;
+            if (families[f] == "bipartite")
+            {
+                pairs_path = base + ".pairs.txt";
+                FILE *pairs = fopen(pairs_path.c_str(), "w");
+                CountingWriter writer(pairs);
+                FamilyRandom random(seed);
+                bipartite_family(sizes[s], random, writer, false);
+                fclose(pairs);
+                pairs_n = writer.n;
+                // the same pairs with weights, drawn from their own stream so the pairs do not change
+                weighted_path = base + ".weighted.txt";
+                FILE *weighted = fopen(weighted_path.c_str(), "w");
+                WeightedPairWriter weights(weighted, seed + 1);
+                FamilyRandom again(seed);
+                bipartite_family(sizes[s], again, weights, false);
+                fclose(weighted);
+            }
+
+            // only the parallel engines run once per thread count, the others are sequential;
+            // the assignment engines are checked against each other, their value is a weight
+            long long reference = -1, weight_reference = -1;
+            size_t first = results.size();
+            for (size_t e = 0; e < engines.size(); e++)
+            {
+                bool parallel = engines[e] == "parallel" || engines[e] == "auction";
+                size_t sweep = parallel ? thread_counts.size() : 1;
+                for (size_t t = 0; t < sweep; t++)
+                {
+                    BenchmarkResult result;
+                    result.engine = engines[e];
+                    result.family = families[f];
+                    result.size = sizes[s];
+                    result.n = count.n;
+                    result.m = count.m;
+                    result.repeats = 0;
+                    result.threads = parallel ? thread_counts[t] : 1;
+                    result.load[0] = result.load[1] = result.solve[0] = result.solve[1] = result.cut[0] = result.cut[1] = 0;
+                    result.speedup = 0;
+                    result.value = -1;
+                    result.peak_rss_kb = 0;
+                    if (is_matching_engine(engines[e]) && families[f] != "bipartite")
+                    {
+                        continue;
+                    }
+                    if (gave_up[e * thread_counts.size() + t] || (engines[e] == "hungarian" && pairs_n > HUNGARIAN_MAX_N))
+                    {
+                        result.status = "skipped";
+                    }
+                    else
+                    {
+                        const string &input = is_assignment_engine(engines[e]) ? weighted_path : is_matching_engine(engines[e]) ? pairs_path : path;
+                        measure(result, input, result.threads, warmup, repeats, time_limit);
+                    }
+                    if (result.status == "timeout")
+                    {
+                        gave_up[e * thread_counts.size() + t] = true;
+                    }
+                    if (result.status == "ok")
+                    {
+                        long long &expected = is_assignment_engine(engines[e]) ? weight_reference : reference;
+                        if (expected < 0)
+                        {
+                            expected = result.value;
+                        }
+                        else if (result.value != expected)
+                        {
+                            result.status = "mismatch";
+                        }
+                    }
+                    cerr << result.engine << " " << result.family << " " << result.size << " threads " << result.threads << ": "
+                         << result.status << ", median solve " << result.solve[0] << " us" << endl;
+                    results.push_back(result);
+                }
+            }
+
+            // every engine is compared with the sequential push-relabel on the same instance
+            double sequential = 0;
+            for (size_t i = first; i < results.size(); i++)
+            {
+                if (results[i].engine == "hlpp" && results[i].status == "ok")
+                {
+                    sequential = results[i].solve[0];
+                }
+            }
+            for (size_t i = first; i < results.size(); i++)
+            {
+                if (sequential > 0 && results[i].status == "ok" && results[i].solve[0] > 0)
+                {
+                    results[i].speedup = sequential / results[i].solve[0];
+                }
+            }
+            remove(path.c_str());
+            if (!pairs_path.empty())
+            {
+                remove(pairs_path.c_str());
+                remove(weighted_path.c_str());
+            }
+        }
+    }
+
+    ofstream file;
+    if (!output.empty())
+    {
+        file.open(output.c_str());
+    }
+    ostream &out = output.empty() ? cout : file;
+    if (format == "json")
+    {
+        write_json(out, results, seed);
+    }
+    else
+    {
+        write_csv(out, results);
+    }
+
+    if (!baseline.empty())
+    {
+        int regressions = compare_baseline(baseline, results, tolerance);
+        if (regressions != 0)
+        {
+            return 2;
+        }
+    }
+    return 0;
+}
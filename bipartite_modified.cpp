@@ -1,308 +1,165 @@
 #include <iostream>
 #include <vector>
-#include <climits>
-#include <queue>
-#include <fstream>
+#include <cstdlib>
+#include <string>
+#include "matching.h"
+#include "assignment.h"
+#include "result_export.h"
 using namespace std;
- 
-struct Edge
-{
-    int u, v;     // Source and destination nodes
-    int capacity; // Capacity of the edge
-    int flow;     // Current flow on the edge
-    // Edge* residual;        // Pointer to the residual edge in the residual graph
- 
-    // Constructor to initialize the edge
-    Edge(int u, int v, int capacity) : u(u), v(v), capacity(capacity), flow(0) {}
-};
- 
-struct ResidualEdge : Edge
-{
-    int forward_edge_idx;  // Index of the forward edge in the adjacency list
-    int backward_edge_idx; // Index of the backward edge in the adjacency list
- 
-    // Constructor to initialize the residual edge
-    ResidualEdge(int u, int v, int capacity, int forward_edge_idx, int backward_edge_idx) : Edge(u, v, capacity), forward_edge_idx(forward_edge_idx), backward_edge_idx(backward_edge_idx) {}
-};
- 
-class Graph
-{
-public:
-    int n;                                       // number of vertices in the graph
-    vector<vector<Edge *>> adj;                  // adjacency matrix to store the edges in the graph
-    vector<vector<ResidualEdge *>> residual_adj; // adjacency matrix to store the edges in the residual graph
-    // vector<bool> visited;                        // to keep track of visited nodes while calculation the augmented path
- 
-    // constructor to initialize the graph
-    Graph(int n);
- 
-    // method to add an edge to the graph
-    void add_edge(int u, int v, int capacity);
- 
-    // method to create the residual graph from the original graph
-    void create_residual_graph();
- 
-    // method to find an augmenting path in the residual graph using DFS
-    bool dfs(int source, int sink, vector<ResidualEdge *> &parent, vector<bool> &visited);
-    vector<ResidualEdge *> find_augmenting_path(int source, int sink);
- 
-    // method to run the Ford-Fulkerson algorithm on the graph
-    int max_flow(int source, int sink);
- 
-    // method to implement st_cut
-    vector<pair<int, int>> st_cut(int source, int sink);
- 
-    //helper function for the st_cut
-    void dfs_cut(int u, int sink, vector<bool> &visited);
- 
-};
- 
-Graph::Graph(int n)
-{
-    this->n = n;
-    adj.resize(n, vector<Edge *>(n, nullptr));
-    residual_adj.resize(n, vector<ResidualEdge *>(n, nullptr));
-    // visited.resize(n, false);
-}
- 
-void Graph::add_edge(int u, int v, int capacity)
-{
-    Edge *e = new Edge(u, v, capacity);
-    //    Edge* e_res = new Edge(v, u, 0);
-    e->flow = 0;
-    // e->residual = e_res;
-    // e_res->residual = e;
-    adj[u][v] = e;
-}
- 
-void Graph::create_residual_graph()
+
+// solves a `u v weight` input for a matching of maximum total weight and exports it like a matching
+static int run_weighted(const string &path, const string &method, int threads, const string &export_path)
 {
-    for (int u = 0; u < n; u++)
+    WeightedAssignment G(0);
+    string error;
+    if (!load_weighted_bipartite(path, G, error))
     {
-        for (int v = 0; v < n; v++)
-        {
-            if (adj[u][v])
-            {
-                // Create forward edge in residual graph only if c(e)-f(e) is non zero
-                if (adj[u][v]->capacity - adj[u][v]->flow > 0)
-                {
- 
-                    ResidualEdge *forward_edge = new ResidualEdge(u, v, adj[u][v]->capacity - adj[u][v]->flow, adj[u].size() - 1, residual_adj[v].size());
-                    residual_adj[u][v] = forward_edge;
-                }
-                else if (adj[u][v]->capacity - adj[u][v]->flow == 0)
-                {
-                    residual_adj[u][v] = nullptr;
-                }
- 
-                // Create backward edge in residual graph only if the flow in the backward edge is non zero
-                if (adj[u][v]->flow != 0)
-                {
-                    ResidualEdge *backward_edge = new ResidualEdge(v, u, adj[u][v]->flow, residual_adj[v].size(), adj[u].size() - 1);
-                    residual_adj[v][u] = backward_edge;
-                }
-                else
-                {
-                    residual_adj[v][u] = nullptr;
-                }
- 
-                // Set pointers to residual edges
-                // forward_edge->residual = backward_edge;
-                // backward_edge->residual = forward_edge;
-            }
-        }
+        cerr << error << endl;
+        return 1;
     }
-}
- 
-bool Graph::dfs(int s, int t, vector<ResidualEdge *> &parent, vector<bool> &visited)
-{
-    // Mark the current vertex as visited
-    visited[s] = true;
- 
-    // If s is the sink, return true
-    if (s == t)
+    if (threads > 0)
     {
-        return true;
+        G.threads = threads;
     }
- 
-    // Loop through all adjacent vertices of s in the residual graph
-    for (int v = 0; v < n; v++)
+    AssignmentMethod engine = method == "auction" ? ASSIGN_AUCTION : method == "hungarian" ? ASSIGN_HUNGARIAN : ASSIGN_AUTO;
+    long long a = G.solve(engine);
+
+    // the export thread writes the edges while the pairs are printed
+    ResultWriter writer;
+    if (export_path != "none")
     {
-        // If v is not visited and has positive residual capacity
-        if (!visited[v] && residual_adj[s][v] != nullptr)
+        if (!writer.open(export_path, export_format_of(export_path), error))
+        {
+            cerr << error << endl;
+            return 1;
+        }
+        writer.begin(RESULT_ASSIGNMENT, G.n, -1, -1, a, G.edge_list.size());
+        // of parallel edges only the heaviest one, which the weight counts, is marked
+        vector<int> chosen(G.n, -1);
+        for (int i = 0; i < (int)G.edge_list.size(); i++)
         {
-            // Set v as the parent of s
-            parent[v] = new ResidualEdge(s, v, residual_adj[s][v]->capacity, 0, 0);
- 
-            // Recursively do DFS from v to t
-            if (dfs(v, t, parent, visited))
+            int u = G.edge_list[i].first, v = G.edge_list[i].second;
+            if (G.match_left[u] == v && (chosen[u] < 0 || G.edge_weight[i] > G.edge_weight[chosen[u]]))
             {
-                return true;
+                chosen[u] = i;
             }
         }
-    }
- 
-    // If no augmenting path is found from s, return false
-    return false;
-}
-vector<ResidualEdge *> Graph::find_augmenting_path(int source, int sink)
-{
-    vector<bool> visited(n, false);
-    vector<ResidualEdge *> parent(n, nullptr);
- 
-    if (!dfs(source, sink, parent, visited))
-    {
-        for (int i = 0; i < n; i++)
+        vector<ResultRecord> batch;
+        for (int i = 0; i < (int)G.edge_list.size(); i++)
         {
-            parent[i] = nullptr;
+            int u = G.edge_list[i].first, v = G.edge_list[i].second;
+            bool matched = chosen[u] == i;
+            ResultRecord r = {u, v, G.edge_weight[i], matched, matched ? RESULT_MATCHED : 0, 0};
+            batch.push_back(r);
         }
+        writer.add_edges(batch);
+        writer.end();
     }
-    return parent;
+
+    vector<pair<int, int>> pairs = G.matched_pairs();
+    cout << "maximum weight is :- " << a << " with " << pairs.size() << " edges" << endl;
+    for (int i = 0; i < (int)pairs.size(); i++)
+    {
+        cout << pairs[i].first << " " << pairs[i].second << endl;
+    }
+    if (!writer.finish(error))
+    {
+        cerr << error << endl;
+        return 1;
+    }
+    return 0;
 }
- 
-int Graph::max_flow(int source, int sink)
+
+int main(int argc, char **argv)
 {
-    int max_flow = 0;
-    while (true)
+    string path = "inputBipartite.txt";
+    string mode = "auto"; // bitset rows for dense inputs, adjacency lists otherwise
+    string export_path = "resultBipartite.json";
+    string assign;   // --assign: auto, auction or hungarian, reads `u v weight` lines
+    int threads = 0; // 0 keeps the hardware concurrency
+    for (int i = 1; i < argc; i++)
     {
-        // cout << 0 << "//////" << endl;
-        create_residual_graph();
-        // for (int i = 0; i < residual_adj.size(); i++)
-        // {
-        //     for (int j = 0; j < residual_adj[i].size(); j++)
-        //     {
-        //         if (residual_adj[i][j] != nullptr)
-        //             cout << residual_adj[i][j]->u << " " << residual_adj[i][j]->v << " " << residual_adj[i][j]->capacity << endl;
-        //     }
-        // }
-        // cout << endl;
-        vector<ResidualEdge *> augmenting_path = find_augmenting_path(source, sink);
-        // for (int v = sink; v != source; v = augmenting_path[v]->u)
-        // {
-        //     cout << augmenting_path[v]->u << " ";
-        // }
-        // cout << endl;
-        if (!augmenting_path[sink])
+        string arg = argv[i];
+        if (arg == "--dense" || arg == "--sparse")
         {
-            break;
+            mode = arg.substr(2);
         }
- 
-        int path_flow = INT_MAX;
-        for (int v = sink; v != source; v = augmenting_path[v]->u)
+        else if (arg == "--export" && i + 1 < argc)
         {
-            path_flow = min(path_flow, augmenting_path[v]->capacity); // finding the bottleneck capacity
+            export_path = argv[++i];
         }
-        // for the particular augmented edge selected we change the flow of the edges in the acutal graph.
-        // for (int v = sink; v != source; v = augmenting_path[v]->u)
-        // {
-        //     cout << augmenting_path[v]->u << " " << augmenting_path[v]->v << " " << augmenting_path[v]->capacity << endl;
-        // }
-        // cout << path_flow << endl;
-        for (int v = sink; v != source; v = augmenting_path[v]->u)
+        else if (arg == "--assign" && i + 1 < argc)
         {
-            if (!adj[augmenting_path[v]->u][v])
-            {
-                adj[v][augmenting_path[v]->u]->flow -= path_flow;
-            }
-            else
-                adj[augmenting_path[v]->u][v]->flow += path_flow;
+            assign = argv[++i];
         }
-        // for (int v = sink; v != source; v = augmenting_path[v]->u)
-        // {
-        //     ResidualEdge *forward_edge = augmenting_path[v];
-        //     ResidualEdge *backward_edge = residual_adj[v][forward_edge->u];
- 
-        //     forward_edge->capacity -= path_flow;
-        //     if (backward_edge)
-        //     {
-        //         backward_edge->capacity += path_flow;
-        //     }
-        //     else
-        //     {
-        //         ResidualEdge *new_backward_edge = new ResidualEdge(v, forward_edge->u, path_flow, residual_adj[v].size(), forward_edge->forward_edge_idx);
-        //         residual_adj[v][forward_edge->u] = new_backward_edge;
-        //     }
- 
-        //     adj[forward_edge->u][forward_edge->v]->flow += path_flow;
-        // }
-        max_flow += path_flow;
-    }
- 
-    return max_flow;
-}
- 
-vector<pair<int, int>> Graph::st_cut(int source, int sink) {
-    // Run the Ford-Fulkerson algorithm to find the max flow
-    max_flow(source, sink);
- 
-    // Perform a DFS on the residual graph to find the set of vertices reachable from the source
-    vector<bool> visited(n, false);
-    dfs_cut(source, sink, visited);
- 
-    // Find the edges crossing the cut (from the visited set to the unvisited set)
-    vector<pair<int, int>> cut_edges;
-    for (int u = 0; u < n; u++) {
-        if (visited[u]) {
-            for (int v = 0; v < n; v++) {
-                if (!visited[v] && adj[u][v]) {
-                    cut_edges.push_back(make_pair(u, v));
-                }
-            }
+        else if (arg == "--threads" && i + 1 < argc)
+        {
+            threads = atoi(argv[++i]);
+        }
+        else if (arg[0] != '-')
+        {
+            path = arg;
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--dense | --sparse] [--export file.json|file.dot|file.bin|none] [--assign auto|auction|hungarian [--threads k]] [input]" << endl;
+            return 1;
         }
     }
- 
-    return cut_edges;
-}
- 
-// Helper method to perform DFS on the residual graph
-void Graph::dfs_cut(int u, int sink, vector<bool> &visited) {
-    visited[u] = true;
- 
-    for (int v = 0; v < n; v++) {
-        if (!visited[v] && residual_adj[u][v] && residual_adj[u][v]->capacity > 0) {
-            dfs_cut(v, sink, visited);
+    if (!assign.empty())
+    {
+        if (assign != "auto" && assign != "auction" && assign != "hungarian")
+        {
+            cerr << "unknown assignment engine " << assign << ", expected auto, auction or hungarian" << endl;
+            return 1;
         }
+        return run_weighted(path, assign, threads, export_path);
     }
-}
- 
- 
-int main()
-{
-    ifstream infile("inputBipartite.txt");
- 
 
-    int n; infile>>n;
-    
- 
-    Graph G(n+2);
-    int source, sink;
-    // infile >> source >> sink;
-    source=n; sink=n+1;
-    //user enters size of 
-    //now user enters which nodes are in set U
-    int u, v;
-    while (infile >> u >> v )
+    BipartiteGraph G(0);
+    string error;
+    if (!load_bipartite(path, G, error))
+    {
+        cerr << error << endl;
+        return 1;
+    }
+    bool dense = mode == "dense" || (mode == "auto" && G.is_dense());
+    int a = dense ? G.dense_matching() : G.hopcroft_karp();
+
+    // every edge with its matched flag, formatted and written by the export thread while the pairs are printed
+    ResultWriter writer;
+    if (export_path != "none")
     {
-        // cout << u << " " << v << " " << capacity << endl;
-        G.add_edge(u, v, 1);
-        G.add_edge(source,u,1);
-        G.add_edge(v,sink,1);
+        if (!writer.open(export_path, export_format_of(export_path), error))
+        {
+            cerr << error << endl;
+            return 1;
+        }
+        writer.begin(RESULT_MATCHING, G.n, -1, -1, a, G.edge_list.size());
+        vector<ResultRecord> batch;
+        vector<char> taken(G.n, 0); // of parallel edges only the first one is marked
+        for (int i = 0; i < (int)G.edge_list.size(); i++)
+        {
+            int u = G.edge_list[i].first, v = G.edge_list[i].second;
+            bool matched = G.match_left[u] == v && !taken[u];
+            taken[u] |= matched;
+            ResultRecord r = {u, v, 1, matched, matched ? RESULT_MATCHED : 0, 0};
+            batch.push_back(r);
+        }
+        writer.add_edges(batch);
+        writer.end();
     }
-    // G.create_residual_graph();
-    // vector<ResidualEdge*> ans = G.find_augmenting_path(2,4);
-    // (!ans[4])?cout << 1 << endl:cout << 0 << endl;
-    // for(int v = 2;v != 4;v = ans[v]->u){
-    //     cout << ans[v]->u << " " << ans[v]->v << endl;
-    // }
-    int a = G.max_flow(source, sink);
-    // vector<pair<int,int>> st_cut_edges = G.st_cut(source,sink);
-    // for(int i = 0;i < st_cut_edges.size();i++){
-    //     cout << st_cut_edges[i].first << " " << st_cut_edges[i].second << endl;
-    // } 
+
     cout << "maximum number of edges are :- "<< a << endl;
-    string filename = "plotBipartite.py";
-    string command = "python ";
-    command += filename;
-    system(command.c_str());
+    vector<pair<int, int>> pairs = G.matched_pairs();
+    for (int i = 0; i < (int)pairs.size(); i++)
+    {
+        cout << pairs[i].first << " " << pairs[i].second << endl;
+    }
+    if (!writer.finish(error))
+    {
+        cerr << error << endl;
+        return 1;
+    }
     return 0;
-}
\ No newline at end of file
+}
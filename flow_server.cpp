@@ -0,0 +1,599 @@
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <limits>
+#include <csignal>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include "maxflow.h"
+#include "matching.h"
+using namespace std;
+
+/**
+ * @brief One client stream: a socket, or standard input and output.
+ *
+ * Requests are read on the client's own thread, responses are written by whichever worker
+ * answered them, one whole line at a time under write_lock. The descriptors close when the
+ * reader and the last pending job have let go of the connection.
+ */
+struct Connection
+{
+    int in, out;
+    mutex write_lock;
+
+    Connection(int in, int out) : in(in), out(out) {}
+    ~Connection()
+    {
+        if (in > 2)
+        {
+            close(in);
+        }
+        if (out > 2 && out != in)
+        {
+            close(out);
+        }
+    }
+
+    // method to write one response line, a client that went away is ignored
+    void send(const string &line)
+    {
+        lock_guard<mutex> guard(write_lock);
+        string framed = line + "\n";
+        for (size_t done = 0; done < framed.size();)
+        {
+            ssize_t k = write(out, framed.data() + done, framed.size() - done);
+            if (k < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            if (k <= 0)
+            {
+                return;
+            }
+            done += k;
+        }
+    }
+};
+
+/**
+ * @brief A request waiting for its graph.
+ */
+struct Job
+{
+    shared_ptr<Connection> client;
+    string id;           // echoed in front of the response so pipelined requests can be matched
+    string command;
+    vector<string> args; // arguments after the graph name
+};
+
+/**
+ * @brief A named graph kept in memory between requests.
+ *
+ * Jobs on one graph run one at a time in arrival order, so an update is always seen by the
+ * queries sent after it, while jobs on different graphs run on different workers.
+ */
+struct Resident
+{
+    string name;
+    unique_ptr<Graph> flow;            // flow network, or
+    unique_ptr<BipartiteGraph> pairs;  // bipartite graph
+    int source, sink;                  // terminals recorded in the file
+    vector<long long> outgoing;        // capacity out of every vertex, kept current by the updates
+    vector<long long> incoming;        // capacity into every vertex
+    mutex lock;
+    deque<Job> pending;
+    bool scheduled; // true while the graph sits in the ready queue or a worker runs its job
+};
+
+/**
+ * @brief The resident graphs and the workers that answer requests on them.
+ */
+class Server
+{
+public:
+    Server(int workers);
+    ~Server();
+
+    // method to parse one request line and queue it on its graph, or answer it right away
+    void dispatch(const shared_ptr<Connection> &client, const string &line);
+
+    // method to read requests from a client until it closes the stream
+    void serve(shared_ptr<Connection> client);
+
+    // method to wait until every queued request has been answered
+    void drain();
+
+private:
+    mutex table_lock;
+    map<string, shared_ptr<Resident>> graphs;
+
+    mutex ready_lock;
+    condition_variable ready_signal, idle_signal;
+    deque<shared_ptr<Resident>> ready; // graphs with pending jobs and no worker on them
+    long long outstanding;             // jobs queued or running
+    bool stopping;                     // set by the destructor to let the workers exit
+    vector<thread> pool;
+
+    void worker();
+    void schedule(const shared_ptr<Resident> &graph);
+    string run(Resident &graph, const Job &job);
+};
+
+Server::Server(int workers)
+{
+    outstanding = 0;
+    stopping = false;
+    for (int w = 0; w < workers; w++)
+    {
+        pool.push_back(thread(&Server::worker, this));
+    }
+}
+
+Server::~Server()
+{
+    drain();
+    {
+        lock_guard<mutex> guard(ready_lock);
+        stopping = true;
+        ready_signal.notify_all();
+    }
+    for (size_t w = 0; w < pool.size(); w++)
+    {
+        pool[w].join();
+    }
+}
+
+void Server::schedule(const shared_ptr<Resident> &graph)
+{
+    lock_guard<mutex> guard(ready_lock);
+    ready.push_back(graph);
+    ready_signal.notify_one();
+}
+
+void Server::dispatch(const shared_ptr<Connection> &client, const string &line)
+{
+    istringstream in(line);
+    Job job;
+    string name, arg;
+    if (!(in >> job.id))
+    {
+        return; // blank line
+    }
+    if (!(in >> job.command))
+    {
+        client->send(job.id + " error missing command");
+        return;
+    }
+    if (job.command == "list")
+    {
+        string names;
+        lock_guard<mutex> guard(table_lock);
+        for (map<string, shared_ptr<Resident>>::iterator it = graphs.begin(); it != graphs.end(); ++it)
+        {
+            names += " " + it->first;
+        }
+        client->send(job.id + " ok " + to_string(graphs.size()) + names);
+        return;
+    }
+    if (!(in >> name))
+    {
+        client->send(job.id + " error missing graph name");
+        return;
+    }
+    job.client = client;
+    while (in >> arg)
+    {
+        job.args.push_back(arg);
+    }
+
+    // loads create the entry right away so requests sent after them queue behind the load
+    shared_ptr<Resident> graph;
+    {
+        lock_guard<mutex> guard(table_lock);
+        map<string, shared_ptr<Resident>>::iterator it = graphs.find(name);
+        if (job.command == "load" || job.command == "load_pairs")
+        {
+            if (it == graphs.end())
+            {
+                graph.reset(new Resident());
+                graph->name = name;
+                graph->source = graph->sink = -1;
+                graph->scheduled = false;
+                graphs[name] = graph;
+            }
+            else
+            {
+                graph = it->second;
+            }
+        }
+        else if (it == graphs.end())
+        {
+            client->send(job.id + " error unknown graph " + name);
+            return;
+        }
+        else
+        {
+            graph = it->second;
+            if (job.command == "drop")
+            {
+                graphs.erase(it); // the queued jobs still finish on the detached graph
+            }
+        }
+    }
+
+    {
+        lock_guard<mutex> guard(ready_lock);
+        outstanding++;
+    }
+    bool idle;
+    {
+        lock_guard<mutex> guard(graph->lock);
+        graph->pending.push_back(job);
+        idle = !graph->scheduled;
+        graph->scheduled = true;
+    }
+    if (idle)
+    {
+        schedule(graph);
+    }
+}
+
+void Server::worker()
+{
+    for (;;)
+    {
+        shared_ptr<Resident> graph;
+        {
+            unique_lock<mutex> guard(ready_lock);
+            ready_signal.wait(guard, [this] { return !ready.empty() || stopping; });
+            if (ready.empty())
+            {
+                return;
+            }
+            graph = ready.front();
+            ready.pop_front();
+        }
+
+        // one job per turn, then the graph goes to the back so busy graphs do not starve the others
+        Job job;
+        {
+            lock_guard<mutex> guard(graph->lock);
+            job = graph->pending.front();
+            graph->pending.pop_front();
+        }
+        job.client->send(job.id + " " + run(*graph, job));
+        bool more;
+        {
+            lock_guard<mutex> guard(graph->lock);
+            more = !graph->pending.empty();
+            graph->scheduled = more;
+        }
+        if (more)
+        {
+            schedule(graph);
+        }
+        lock_guard<mutex> guard(ready_lock);
+        if (--outstanding == 0)
+        {
+            idle_signal.notify_all();
+        }
+    }
+}
+
+void Server::drain()
+{
+    unique_lock<mutex> guard(ready_lock);
+    idle_signal.wait(guard, [this] { return outstanding == 0; });
+}
+
+// reads a vertex or edge index argument, false if it is missing, malformed or not below limit
+static bool parse_index(const vector<string> &args, size_t i, int limit, int &value)
+{
+    if (i >= args.size())
+    {
+        return false;
+    }
+    char *end;
+    long v = strtol(args[i].c_str(), &end, 10);
+    if (*end || end == args[i].c_str() || v < 0 || v >= limit)
+    {
+        return false;
+    }
+    value = v;
+    return true;
+}
+
+// reads an optional source and sink, keeping the ones recorded in the file when absent
+static bool parse_terminals(const Resident &graph, const vector<string> &args, int &source, int &sink)
+{
+    source = graph.source;
+    sink = graph.sink;
+    if (args.empty())
+    {
+        return true;
+    }
+    return parse_index(args, 0, graph.flow->n, source) && parse_index(args, 1, graph.flow->n, sink) && source != sink;
+}
+
+// adds up the capacity out of and into every vertex of a freshly loaded flow network
+static void count_capacities(Resident &graph)
+{
+    const Graph &G = *graph.flow;
+    graph.outgoing.assign(G.n, 0);
+    graph.incoming.assign(G.n, 0);
+    for (int i = 0; i < G.m; i++)
+    {
+        graph.outgoing[G.edges[i].u] += G.edges[i].capacity;
+        graph.incoming[G.edges[i].v] += G.edges[i].capacity;
+    }
+}
+
+// checks in O(1) that the capacities out of u and into v still add up within a Flow after a u -> v edge changes by delta
+static bool fits_capacity_change(const Resident &graph, int u, int v, long long delta, const string &what, string &error)
+{
+    if (graph.outgoing[u] + delta > numeric_limits<Graph::Flow>::max() || graph.incoming[v] + delta > numeric_limits<Graph::Flow>::max())
+    {
+        error = "the capacities of " + what + " (" + to_string(u) + ", " + to_string(v) +
+                ") would add up beyond the range of the capacity type at one of its ends";
+        return false;
+    }
+    return true;
+}
+
+string Server::run(Resident &graph, const Job &job)
+{
+    const vector<string> &args = job.args;
+    string error;
+    if (job.command == "load" || job.command == "load_pairs")
+    {
+        if (args.empty())
+        {
+            return "error missing path";
+        }
+        if (job.command == "load_pairs")
+        {
+            unique_ptr<BipartiteGraph> B(new BipartiteGraph(0));
+            if (!load_bipartite(args[0], *B, error))
+            {
+                return "error " + error;
+            }
+            graph.flow.reset();
+            graph.pairs.swap(B);
+            return "ok " + to_string(graph.pairs->n) + " " + to_string(graph.pairs->edge_list.size());
+        }
+        // a failed load keeps the graph and the terminals it replaces
+        unique_ptr<Graph> G(new Graph(1));
+        int source, sink;
+        if (!load_graph(args[0], *G, source, sink, error))
+        {
+            return "error " + error;
+        }
+        if (source == sink)
+        {
+            return "error " + args[0] + ": the source and the sink must be different vertices";
+        }
+        if (args.size() > 1)
+        {
+            const char *names[] = {"ff", "ek", "dinic", "hlpp", "parallel"};
+            int k = 0;
+            while (k < 5 && args[1] != names[k])
+            {
+                k++;
+            }
+            if (k == 5)
+            {
+                return "error unknown algorithm " + args[1];
+            }
+            G->algorithm = (FlowAlgorithm)k;
+        }
+        graph.pairs.reset();
+        graph.flow.swap(G);
+        graph.source = source;
+        graph.sink = sink;
+        count_capacities(graph);
+        return "ok " + to_string(graph.flow->n) + " " + to_string(graph.flow->m);
+    }
+    if (job.command == "drop")
+    {
+        return "ok";
+    }
+    if (job.command == "matching")
+    {
+        if (!graph.pairs)
+        {
+            return "error " + graph.name + " is not a bipartite graph";
+        }
+        BipartiteGraph &B = *graph.pairs;
+        int size = B.is_dense() ? B.dense_matching() : B.hopcroft_karp();
+        vector<pair<int, int>> matched = B.matched_pairs();
+        string out = "ok " + to_string(size);
+        for (size_t i = 0; i < matched.size(); i++)
+        {
+            out += " " + to_string(matched[i].first) + " " + to_string(matched[i].second);
+        }
+        return out;
+    }
+    if (!graph.flow)
+    {
+        return "error " + graph.name + " is not a flow network";
+    }
+    Graph &G = *graph.flow;
+    int source, sink, edge, u, v;
+    if (job.command == "maxflow" || job.command == "mincut")
+    {
+        if (!parse_terminals(graph, args, source, sink))
+        {
+            return "error bad source or sink";
+        }
+        if (job.command == "maxflow")
+        {
+            return "ok " + to_string(G.max_flow(source, sink));
+        }
+        CutResult cut = G.min_cut(source, sink);
+        string out = "ok " + to_string(cut.value) + " " + to_string(cut.edges.size());
+        for (size_t i = 0; i < cut.edges.size(); i++)
+        {
+            out += " " + to_string(G.edges[cut.edges[i]].u) + " " + to_string(G.edges[cut.edges[i]].v);
+        }
+        return out;
+    }
+
+    // updates are checked like a load so the next solve cannot overflow, against the sums kept on the graph
+    long capacity;
+    char *end;
+    if (job.command == "set" || job.command == "remove")
+    {
+        if (!parse_index(args, 0, G.m, edge))
+        {
+            return "error bad edge index";
+        }
+        capacity = 0;
+        if (job.command == "set")
+        {
+            if (args.size() < 2)
+            {
+                return "error missing capacity";
+            }
+            capacity = strtol(args[1].c_str(), &end, 10);
+            if (*end || capacity < 0 || capacity > INT_MAX)
+            {
+                return "error bad capacity " + args[1];
+            }
+        }
+        u = G.edges[edge].u;
+        v = G.edges[edge].v;
+        long long delta = capacity - (long long)G.edges[edge].capacity;
+        if (!fits_capacity_change(graph, u, v, delta, "edge " + to_string(edge), error))
+        {
+            return "error " + error;
+        }
+        G.set_capacity(edge, capacity);
+        graph.outgoing[u] += delta;
+        graph.incoming[v] += delta;
+        return "ok";
+    }
+    if (job.command == "add")
+    {
+        if (!parse_index(args, 0, G.n, u) || !parse_index(args, 1, G.n, v) || args.size() < 3)
+        {
+            return "error expected u v capacity";
+        }
+        capacity = strtol(args[2].c_str(), &end, 10);
+        if (*end || capacity < 0 || capacity > INT_MAX)
+        {
+            return "error bad capacity " + args[2];
+        }
+        // the edge is checked before it is added, so a rejected one leaves no trace in the graph
+        if (!fits_capacity_change(graph, u, v, capacity, "a new edge", error))
+        {
+            return "error " + error;
+        }
+        graph.outgoing[u] += capacity;
+        graph.incoming[v] += capacity;
+        return "ok " + to_string(G.add_edge(u, v, capacity));
+    }
+    return "error unknown command " + job.command;
+}
+
+void Server::serve(shared_ptr<Connection> client)
+{
+    string buffer;
+    char chunk[1 << 16];
+    for (;;)
+    {
+        ssize_t k = read(client->in, chunk, sizeof(chunk));
+        if (k < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (k <= 0)
+        {
+            break;
+        }
+        buffer.append(chunk, k);
+        size_t start = 0, end;
+        while ((end = buffer.find('\n', start)) != string::npos)
+        {
+            dispatch(client, buffer.substr(start, end - start));
+            start = end + 1;
+        }
+        buffer.erase(0, start);
+    }
+    if (!buffer.empty())
+    {
+        dispatch(client, buffer);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    int workers = max(1u, thread::hardware_concurrency());
+    string socket_path; // empty: serve standard input and output
+    for (int i = 1; i < argc; i++)
+    {
+        string arg = argv[i];
+        if (arg == "--workers" && i + 1 < argc)
+        {
+            workers = max(1, atoi(argv[++i]));
+        }
+        else if (arg == "--socket" && i + 1 < argc)
+        {
+            socket_path = argv[++i];
+        }
+        else
+        {
+            cerr << "usage: " << argv[0] << " [--workers k] [--socket path]" << endl;
+            return 1;
+        }
+    }
+    signal(SIGPIPE, SIG_IGN);
+    Server server(workers);
+
+    if (socket_path.empty())
+    {
+        server.serve(make_shared<Connection>(0, 1));
+        return 0; // the server answers what is still queued before it goes
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path))
+    {
+        cerr << socket_path << ": path too long for a socket" << endl;
+        return 1;
+    }
+    strcpy(address.sun_path, socket_path.c_str());
+    unlink(socket_path.c_str());
+    if (listener < 0 || bind(listener, (sockaddr *)&address, sizeof(address)) < 0 || listen(listener, 64) < 0)
+    {
+        cerr << socket_path << ": " << strerror(errno) << endl;
+        return 1;
+    }
+    for (;;)
+    {
+        int fd = accept(listener, nullptr, nullptr);
+        if (fd < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            cerr << socket_path << ": " << strerror(errno) << endl;
+            return 1;
+        }
+        thread(&Server::serve, &server, make_shared<Connection>(fd, fd)).detach();
+    }
+}
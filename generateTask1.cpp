@@ -1,33 +1,133 @@
 #include <iostream>
-#include <fstream>
-#include <ctime>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <cerrno>
+#include <string>
+#include "graph_families.h"
 
-int main() {
-    int N = 30;
-    int E = 60;
-    std::ofstream f("inputTask1.txt");
+/**
+ * @brief Forwards a generated graph to a writer and counts its size for the summary line.
+ */
+template <class Writer>
+struct CountingOutput
+{
+    Writer &writer;
+    int n;
+    long long m;
 
-    if (f.is_open()) {
-        f << N << '\n';
-        f << E << '\n';
+    CountingOutput(Writer &writer) : writer(writer), n(0), m(0) {}
+    void begin(int n, int source, int sink, long long expected)
+    {
+        this->n = n;
+        writer.begin(n, source, sink, expected);
+    }
+    void edge(int u, int v, int capacity)
+    {
+        m++;
+        writer.edge(u, v, capacity);
+    }
+    void end() { writer.end(); }
+};
 
-        std::srand(std::time(0));
+// runs the family into a counting writer and reports what was written
+template <class Writer>
+bool generate(const std::string &family, long long edges, uint64_t seed, bool pairs, Writer &writer, const std::string &output)
+{
+    CountingOutput<Writer> out(writer);
+    if (pairs)
+    {
+        FamilyRandom random(seed);
+        bipartite_family(edges, random, out, false);
+    }
+    else if (!generate_family(family, edges, seed, out))
+    {
+        std::cerr << "unknown family " << family << std::endl;
+        return false;
+    }
+    std::cerr << output << ": " << (pairs ? "bipartite pairs" : family) << ", seed " << seed << ", "
+              << out.n << " vertices, " << out.m << " edges" << std::endl;
+    return true;
+}
 
-        for (int i = 0; i < E; ++i) {
-            int u = std::rand() % N;
-            int v = std::rand() % N;
-            while (u == v) {
-                v = std::rand() % N;
-            }
-            int c = std::rand() % 100 + 1;
-            f << u << ' ' << v << ' ' << c << '\n';
+int main(int argc, char **argv)
+{
+    std::string family = "sparse";
+    long long edges = 60;
+    uint64_t seed = 1;
+    bool binary = false;
+    bool pairs = false; // bipartite matching input instead of a flow network
+    std::string output = "inputTask1.txt";
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        if (arg == "--family" && i + 1 < argc)
+        {
+            family = argv[++i];
         }
-
-        f.close();
-    } else {
-        std::cerr << "Unable to open file";
+        else if (arg == "--edges" && i + 1 < argc)
+        {
+            edges = atoll(argv[++i]);
+        }
+        else if (arg == "--seed" && i + 1 < argc)
+        {
+            seed = strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--binary")
+        {
+            binary = true;
+        }
+        else if (arg == "--pairs")
+        {
+            pairs = true;
+        }
+        else if (arg == "-o" && i + 1 < argc)
+        {
+            output = argv[++i];
+        }
+        else
+        {
+            std::cerr << "usage: " << argv[0] << " [--family sparse|dense|layered|grid|powerlaw|bipartite|adversarial|ak] "
+                      << "[--edges m] [--seed s] [--binary | --pairs] [-o file|-]" << std::endl;
+            return 1;
+        }
+    }
+    if (edges < 1)
+    {
+        std::cerr << "--edges must be positive" << std::endl;
+        return 1;
+    }
+    if (binary && (pairs || output == "-"))
+    {
+        std::cerr << "--binary writes a seekable flow network file, not pairs or stdout" << std::endl;
+        return 1;
     }
 
-    return 0;
-}
\ No newline at end of file
+    FILE *f = output == "-" ? stdout : fopen(output.c_str(), binary ? "wb" : "w");
+    if (!f)
+    {
+        std::cerr << output << ": " << strerror(errno) << std::endl;
+        return 1;
+    }
+    bool ok;
+    if (binary)
+    {
+        BinaryEdgeWriter writer(f);
+        ok = generate(family, edges, seed, false, writer, output);
+    }
+    else
+    {
+        TextEdgeWriter writer(f);
+        ok = generate(family, edges, seed, pairs, writer, output);
+    }
+    if (fflush(f) != 0 || ferror(f))
+    {
+        std::cerr << output << ": write failed" << std::endl;
+        ok = false;
+    }
+    if (f != stdout)
+    {
+        fclose(f);
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,210 @@
+#include "gomory_hu.h"
+#include <thread>
+#include <atomic>
+#include <algorithm>
+
+GomoryHuTree::GomoryHuTree()
+{
+    n = 0;
+}
+
+// solves one Gusfield step on a worker copy, side receives the vertices on the s side of the cut
+static long long solve_step(Graph64 &F, int s, int t, vector<char> &side)
+{
+    // max_flow drops the flow of the previous step, which was solved for another pair
+    long long value = F.max_flow(s, t);
+    F.dfs_cut(s);
+    for (int v = 0; v < F.n; v++)
+    {
+        side[v] = F.is_visited(v);
+    }
+    return value;
+}
+
+void GomoryHuTree::build(const Graph &G, int threads, FlowAlgorithm algorithm)
+{
+    n = G.n;
+    edge_ends.clear();
+    edge_capacity.clear();
+    for (int i = 0; i < G.m; i++)
+    {
+        if (G.edges[i].u != G.edges[i].v && G.edges[i].capacity > 0)
+        {
+            edge_ends.push_back(make_pair(G.edges[i].u, G.edges[i].v));
+            edge_capacity.push_back(G.edges[i].capacity);
+        }
+    }
+    parent.assign(n, 0);
+    weight.assign(n, 0);
+    if (n > 0)
+    {
+        parent[0] = -1;
+    }
+    threads = max(1, min(threads, n - 1));
+    if (algorithm == PARALLEL_PUSH_RELABEL)
+    {
+        algorithm = PUSH_RELABEL;
+    }
+
+    // every worker owns a copy with both directions of every edge, in 64 bits so their sums cannot overflow
+    vector<unique_ptr<Graph64>> workers;
+    for (int w = 0; w < threads && n > 1; w++)
+    {
+        workers.push_back(unique_ptr<Graph64>(new Graph64(n)));
+        Graph64 &F = *workers.back();
+        F.algorithm = algorithm;
+        F.threads = 1;
+        F.reserve_edges(2 * (int)edge_ends.size());
+        for (int i = 0; i < (int)edge_ends.size(); i++)
+        {
+            F.add_edge(edge_ends[i].first, edge_ends[i].second, edge_capacity[i]);
+            F.add_edge(edge_ends[i].second, edge_ends[i].first, edge_capacity[i]);
+        }
+    }
+
+    vector<vector<char>> side(threads, vector<char>(n));
+    vector<int> step_sink(threads);
+    vector<long long> step_value(threads);
+    int next = 1; // first step not committed yet
+    while (next < n)
+    {
+        // solve the next steps against the tree as it is now
+        int batch = min(threads, n - next);
+        for (int j = 0; j < batch; j++)
+        {
+            step_sink[j] = parent[next + j];
+        }
+        atomic<int> claimed(0);
+        auto work = [&](int w)
+        {
+            for (int j; (j = claimed.fetch_add(1)) < batch;)
+            {
+                step_value[j] = solve_step(*workers[w], next + j, step_sink[j], side[j]);
+            }
+        };
+        vector<thread> pool;
+        for (int w = 1; w < batch; w++)
+        {
+            pool.push_back(thread(work, w));
+        }
+        work(0);
+        for (size_t w = 0; w < pool.size(); w++)
+        {
+            pool[w].join();
+        }
+
+        // commit in order while the parent a step was solved against is still its parent
+        for (int j = 0; j < batch && parent[next] == step_sink[j]; j++, next++)
+        {
+            int s = next, t = step_sink[j];
+            const vector<char> &X = side[j];
+            weight[s] = step_value[j];
+            for (int i = 0; i < n; i++)
+            {
+                if (i != s && X[i] && parent[i] == t)
+                {
+                    parent[i] = s;
+                }
+            }
+            if (parent[t] >= 0 && X[parent[t]])
+            {
+                parent[s] = parent[t];
+                parent[t] = s;
+                weight[s] = weight[t];
+                weight[t] = step_value[j];
+            }
+        }
+    }
+    index_subtrees();
+}
+
+void GomoryHuTree::index_subtrees()
+{
+    // children lists by a counting sort over the parents
+    vector<int> first_child(n + 1, 0), children(max(0, n - 1));
+    for (int v = 0; v < n; v++)
+    {
+        if (parent[v] >= 0)
+        {
+            first_child[parent[v] + 1]++;
+        }
+    }
+    for (int v = 0; v < n; v++)
+    {
+        first_child[v + 1] += first_child[v];
+    }
+    vector<int> pos(first_child.begin(), first_child.end() - 1);
+    for (int v = 0; v < n; v++)
+    {
+        if (parent[v] >= 0)
+        {
+            children[pos[parent[v]]++] = v;
+        }
+    }
+
+    // iterative preorder from the root, leave[v] is set once the subtree of v is numbered
+    depth.assign(n, 0);
+    enter.assign(n, 0);
+    leave.assign(n, 0);
+    vector<int> stack, cursor(first_child.begin(), first_child.end() - 1);
+    int clock = 0;
+    if (n > 0)
+    {
+        enter[0] = clock++;
+        stack.push_back(0);
+    }
+    while (!stack.empty())
+    {
+        int u = stack.back();
+        if (cursor[u] == first_child[u + 1])
+        {
+            leave[u] = clock;
+            stack.pop_back();
+            continue;
+        }
+        int v = children[cursor[u]++];
+        depth[v] = depth[u] + 1;
+        enter[v] = clock++;
+        stack.push_back(v);
+    }
+}
+
+int GomoryHuTree::cut_vertex(int u, int v) const
+{
+    int best = -1;
+    while (u != v)
+    {
+        if (depth[u] < depth[v])
+        {
+            swap(u, v);
+        }
+        if (best < 0 || weight[u] < weight[best])
+        {
+            best = u;
+        }
+        u = parent[u];
+    }
+    return best;
+}
+
+long long GomoryHuTree::min_cut_value(int u, int v) const
+{
+    return weight[cut_vertex(u, v)];
+}
+
+vector<pair<int, int>> GomoryHuTree::cut_edges(int u, int v) const
+{
+    int x = cut_vertex(u, v);
+    bool u_below = in_subtree(u, x);
+    vector<pair<int, int>> cut;
+    for (int i = 0; i < (int)edge_ends.size(); i++)
+    {
+        int a = edge_ends[i].first, b = edge_ends[i].second;
+        bool a_below = in_subtree(a, x);
+        if (a_below != in_subtree(b, x))
+        {
+            cut.push_back(a_below == u_below ? make_pair(a, b) : make_pair(b, a));
+        }
+    }
+    return cut;
+}
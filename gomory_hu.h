@@ -0,0 +1,75 @@
+#ifndef GOMORY_HU_H
+#define GOMORY_HU_H
+
+#include <vector>
+#include "maxflow.h"
+using namespace std;
+
+/**
+ * @brief Gomory-Hu cut tree of an undirected capacity graph, built with Gusfield's method.
+ *
+ * Every tree edge (v, parent[v]) carries the minimum v-parent[v] cut value and, removed from
+ * the tree, splits the vertices into the two sides of such a cut. The minimum u-v cut of any
+ * pair is the lightest edge on the tree path between them, so a query needs no max-flow.
+ */
+class GomoryHuTree
+{
+public:
+    int n;                             // number of vertices
+    vector<int> parent;                // tree parent of every vertex, -1 for the root 0
+    vector<long long> weight;          // minimum cut value between v and parent[v]
+    vector<int> depth;                 // distance from the root in tree edges
+    vector<int> enter, leave;          // preorder interval [enter[v], leave[v]) of the subtree of v
+    vector<pair<int, int>> edge_ends;  // undirected edges of the graph
+    vector<int> edge_capacity;
+
+    GomoryHuTree();
+
+    /**
+     * @brief Builds the tree of G, reading every edge as undirected with its capacity.
+     *
+     * Gusfield's method needs n - 1 max-flow computations on the unmodified graph. Each step
+     * depends on the tree left by the ones before it, so the steps run speculatively: every
+     * round solves the next `threads` pending steps in parallel, each on its own copy of the
+     * graph, and commits them in order until one finds its tree parent changed by an earlier
+     * commit. That step and the rest of the round are solved again in the next round.
+     *
+     * @param G The graph. Its source and sink play no role. The copies hold 64-bit capacities,
+     *          since the two directions of an edge may add up past an int at one vertex.
+     * @param threads The worker threads, each holding one copy of the graph.
+     * @param algorithm The engine used for every cut, PARALLEL_PUSH_RELABEL runs as PUSH_RELABEL.
+     */
+    void build(const Graph &G, int threads, FlowAlgorithm algorithm);
+
+    // method to find the lower endpoint of the lightest tree edge between u and v, O(n)
+    int cut_vertex(int u, int v) const;
+
+    /**
+     * @brief Returns the value of a minimum u-v cut in O(n) from the tree path.
+     *
+     * @param u One vertex.
+     * @param v The other vertex, different from u.
+     * @return The capacity of a minimum u-v cut.
+     */
+    long long min_cut_value(int u, int v) const;
+
+    /**
+     * @brief Lists the edges of a minimum u-v cut.
+     *
+     * The cut side is the subtree below the lightest tree edge on the path, so testing an
+     * edge takes O(1) and the listing O(n + E) in total.
+     *
+     * @param u One vertex.
+     * @param v The other vertex, different from u.
+     * @return The (u-side, v-side) endpoints of every undirected edge crossing the cut.
+     */
+    vector<pair<int, int>> cut_edges(int u, int v) const;
+
+    // method to test if w lies in the subtree of x
+    bool in_subtree(int w, int x) const { return enter[x] <= enter[w] && enter[w] < leave[x]; }
+
+    // method to number the subtrees in preorder once the parents are final
+    void index_subtrees();
+};
+
+#endif
@@ -0,0 +1,466 @@
+#ifndef GRAPH_FAMILIES_H
+#define GRAPH_FAMILIES_H
+
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+#include <cstring>
+#include <string>
+#include "maxflow.h"
+using namespace std;
+
+/**
+ * @brief Small deterministic random generator (splitmix64).
+ *
+ * The standard distributions are implementation-defined, so the families draw from this
+ * generator to produce the same graph for the same seed on every platform.
+ */
+struct FamilyRandom
+{
+    uint64_t state;
+
+    FamilyRandom(uint64_t seed) : state(seed) {}
+
+    uint64_t next()
+    {
+        uint64_t z = (state += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        return z ^ (z >> 31);
+    }
+
+    // uniform integer in [0, k), k below 2^31
+    int below(int k) { return (int)(((next() >> 32) * (uint64_t)k) >> 32); }
+
+    // uniform integer in [lo, hi]
+    int between(int lo, int hi) { return lo + below(hi - lo + 1); }
+
+    // uniform double in [0, 1)
+    double unit() { return (next() >> 11) * (1.0 / 9007199254740992.0); }
+};
+
+/**
+ * @brief Names accepted by generate_family, in the order the benchmark runs them.
+ */
+const char *const FAMILY_NAMES[] = {"sparse", "dense", "layered", "grid", "powerlaw", "bipartite", "adversarial", "ak"};
+const int FAMILY_COUNT = sizeof(FAMILY_NAMES) / sizeof(FAMILY_NAMES[0]);
+
+/*
+ * Every family streams its graph into an output object with three methods:
+ *
+ *     void begin(int n, int source, int sink, long long m); // m is the expected edge count
+ *     void edge(int u, int v, int capacity);
+ *     void end();
+ *
+ * and sizes itself so that it has roughly `edges` edges.
+ */
+
+// Erdos-Renyi G(n, m) graph with average out-degree 4 and capacities in [1, 100]
+template <class Out>
+void sparse_family(long long edges, FamilyRandom &random, Out &out)
+{
+    int n = (int)max(2LL, edges / 4);
+    out.begin(n, 0, n - 1, edges);
+    for (long long i = 0; i < edges; i++)
+    {
+        int u = random.below(n);
+        int v = random.below(n - 1);
+        if (v >= u)
+        {
+            v++;
+        }
+        out.edge(u, v, random.between(1, 100));
+    }
+    out.end();
+}
+
+// every ordered pair of vertices is an edge with the same probability
+template <class Out>
+void dense_family(long long edges, FamilyRandom &random, Out &out)
+{
+    int n = (int)sqrt((double)edges * 2) + 2;
+    double p = min(1.0, (double)edges / ((double)n * (n - 1)));
+    out.begin(n, 0, n - 1, edges);
+    for (int u = 0; u < n; u++)
+    {
+        for (int v = 0; v < n; v++)
+        {
+            if (u != v && random.unit() < p)
+            {
+                out.edge(u, v, random.between(1, 100));
+            }
+        }
+    }
+    out.end();
+}
+
+// square-ish layers, every vertex has 4 edges into the next layer, source before the first and sink after the last
+template <class Out>
+void layered_family(long long edges, FamilyRandom &random, Out &out)
+{
+    const int degree = 4;
+    int width = (int)max(2.0, sqrt((double)edges / degree));
+    int layers = (int)max(1LL, edges / ((long long)width * degree));
+    int sink = layers * width + 1;
+    out.begin(sink + 1, 0, sink, (long long)width * (2 + (layers - 1) * degree));
+    for (int i = 0; i < width; i++)
+    {
+        out.edge(0, 1 + i, random.between(1, 100) * degree);
+    }
+    for (int l = 0; l + 1 < layers; l++)
+    {
+        for (int i = 0; i < width; i++)
+        {
+            for (int j = 0; j < degree; j++)
+            {
+                out.edge(1 + l * width + i, 1 + (l + 1) * width + random.below(width), random.between(1, 100));
+            }
+        }
+    }
+    for (int i = 0; i < width; i++)
+    {
+        out.edge(1 + (layers - 1) * width + i, sink, random.between(1, 100) * degree);
+    }
+    out.end();
+}
+
+// vision-style 4-connected grid: every pixel is tied to the source or to the sink, neighbours both ways
+template <class Out>
+void grid_family(long long edges, FamilyRandom &random, Out &out)
+{
+    int side = (int)max(2.0, sqrt((double)edges / 5));
+    int sink = side * side + 1;
+    out.begin(sink + 1, 0, sink, 5LL * side * side);
+    for (int r = 0; r < side; r++)
+    {
+        for (int c = 0; c < side; c++)
+        {
+            int p = 1 + r * side + c;
+            if (random.below(2) == 0)
+            {
+                out.edge(0, p, random.between(1, 100));
+            }
+            else
+            {
+                out.edge(p, sink, random.between(1, 100));
+            }
+            if (c + 1 < side)
+            {
+                out.edge(p, p + 1, random.between(1, 50));
+                out.edge(p + 1, p, random.between(1, 50));
+            }
+            if (r + 1 < side)
+            {
+                out.edge(p, p + side, random.between(1, 50));
+                out.edge(p + side, p, random.between(1, 50));
+            }
+        }
+    }
+    out.end();
+}
+
+/*
+ * Average degree 8, endpoints drawn as n * x^3 for uniform x, so the degree of the vertex of
+ * rank k falls off like k^(-2/3): a power law with exponent about 2.5. The source and the sink
+ * are the two largest hubs.
+ */
+template <class Out>
+void powerlaw_family(long long edges, FamilyRandom &random, Out &out)
+{
+    int n = (int)max(3LL, edges / 4);
+    out.begin(n, 0, 1, edges);
+    for (long long i = 0; i < edges; i++)
+    {
+        double x = random.unit(), y = random.unit();
+        int u = (int)(n * x * x * x);
+        int v = (int)(n * y * y * y);
+        if (u == v)
+        {
+            v = (v + 1) % n;
+        }
+        out.edge(u, v, random.between(1, 100));
+    }
+    out.end();
+}
+
+/*
+ * Random bipartite graph with k vertices per side and 8 edges per left vertex. As a flow
+ * network (flow_network true) it gets a source before the left side and a sink after the
+ * right side, all capacities 1. Otherwise it is emitted as the plain (left, right) pairs of
+ * the matching input, with n = k, no source and no sink.
+ */
+template <class Out>
+void bipartite_family(long long edges, FamilyRandom &random, Out &out, bool flow_network)
+{
+    const int degree = 8;
+    int k = (int)max(1LL, edges / (degree + 2));
+    if (!flow_network)
+    {
+        out.begin(k, -1, -1, (long long)k * degree);
+        for (int u = 0; u < k; u++)
+        {
+            for (int j = 0; j < degree; j++)
+            {
+                out.edge(u, random.below(k), 1);
+            }
+        }
+        out.end();
+        return;
+    }
+    int sink = 2 * k + 1;
+    out.begin(sink + 1, 0, sink, (long long)k * (degree + 2));
+    for (int u = 0; u < k; u++)
+    {
+        out.edge(0, 1 + u, 1);
+        for (int j = 0; j < degree; j++)
+        {
+            out.edge(1 + u, 1 + k + random.below(k), 1);
+        }
+        out.edge(1 + k + u, sink, 1);
+    }
+    out.end();
+}
+
+/*
+ * A chain s -> v1 -> ... -> vk with a unit edge from every vi to the sink. Augmenting-path
+ * engines find the k unit paths one at a time and DFS walks to the far end of the chain for
+ * each of them, so the work grows with k^2.
+ */
+template <class Out>
+void adversarial_family(long long edges, FamilyRandom &random, Out &out)
+{
+    int k = (int)max(2LL, edges / 2);
+    int sink = k + 1;
+    out.begin(k + 2, 0, sink, 2LL * k);
+    out.edge(0, 1, k);
+    for (int i = 1; i <= k; i++)
+    {
+        if (i < k)
+        {
+            out.edge(i, i + 1, k);
+        }
+        out.edge(i, sink, 1);
+    }
+    (void)random;
+    out.end();
+}
+
+/*
+ * Hard instance in the spirit of the AK networks of Cherkassky and Goldberg, with k = edges / 4.
+ * Two gadgets share the source and the sink:
+ * - the chain of adversarial_family, whose k unit exits cost augmenting-path engines k
+ *   augmentations or phases along paths of average length k / 2;
+ * - a chain of k vertices fed with k units by the source but drained by a single unit edge at
+ *   its far end, so push-relabel has to send k - 1 units of excess back along the chain.
+ */
+template <class Out>
+void ak_family(long long edges, FamilyRandom &random, Out &out)
+{
+    int k = (int)max(2LL, edges / 4);
+    int sink = 2 * k + 1;
+    out.begin(sink + 1, 0, sink, 4LL * k + 1);
+    out.edge(0, 1, k);
+    for (int i = 1; i <= k; i++)
+    {
+        if (i < k)
+        {
+            out.edge(i, i + 1, k);
+        }
+        out.edge(i, sink, 1);
+    }
+    out.edge(0, k + 1, k);
+    for (int i = k + 1; i < 2 * k; i++)
+    {
+        out.edge(i, i + 1, k);
+    }
+    out.edge(2 * k, sink, 1);
+    (void)random;
+    out.end();
+}
+
+/**
+ * @brief Streams one graph of a named family into an output object.
+ *
+ * @param family One of FAMILY_NAMES.
+ * @param edges The approximate number of edges to generate.
+ * @param seed The seed, the same seed always gives the same graph.
+ * @param out Receives begin(), one edge() per edge and end().
+ * @return false if the family is unknown.
+ */
+template <class Out>
+bool generate_family(const string &family, long long edges, uint64_t seed, Out &out)
+{
+    FamilyRandom random(seed);
+    if (family == "sparse")
+    {
+        sparse_family(edges, random, out);
+    }
+    else if (family == "dense")
+    {
+        dense_family(edges, random, out);
+    }
+    else if (family == "layered")
+    {
+        layered_family(edges, random, out);
+    }
+    else if (family == "grid")
+    {
+        grid_family(edges, random, out);
+    }
+    else if (family == "powerlaw")
+    {
+        powerlaw_family(edges, random, out);
+    }
+    else if (family == "bipartite")
+    {
+        bipartite_family(edges, random, out, true);
+    }
+    else if (family == "adversarial")
+    {
+        adversarial_family(edges, random, out);
+    }
+    else if (family == "ak")
+    {
+        ak_family(edges, random, out);
+    }
+    else
+    {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Buffered writer of the text edge list read by load_edge_list.
+ *
+ * Without a source (source < 0) it writes the inputBipartite.txt format instead: n, then `u v` lines.
+ */
+class TextEdgeWriter
+{
+public:
+    TextEdgeWriter(FILE *file) : file(file), used(0) {}
+    ~TextEdgeWriter() { flush(); }
+
+    void begin(int n, int source, int sink, long long m)
+    {
+        pairs_only = source < 0;
+        put(n);
+        buffer[used++] = '\n';
+        if (!pairs_only)
+        {
+            put(source);
+            buffer[used++] = ' ';
+            put(sink);
+            buffer[used++] = '\n';
+        }
+        (void)m;
+    }
+
+    void edge(int u, int v, int capacity)
+    {
+        if (used > sizeof(buffer) - 64)
+        {
+            flush();
+        }
+        put(u);
+        buffer[used++] = ' ';
+        put(v);
+        if (!pairs_only)
+        {
+            buffer[used++] = ' ';
+            put(capacity);
+        }
+        buffer[used++] = '\n';
+    }
+
+    void end() { flush(); }
+
+    void flush()
+    {
+        fwrite(buffer, 1, used, file);
+        used = 0;
+    }
+
+private:
+    FILE *file;
+    size_t used;
+    bool pairs_only;
+    char buffer[1 << 16];
+
+    // formats a non-negative integer into the buffer
+    void put(int x)
+    {
+        char digits[12];
+        int k = 0;
+        do
+        {
+            digits[k++] = '0' + x % 10;
+            x /= 10;
+        } while (x > 0);
+        while (k > 0)
+        {
+            buffer[used++] = digits[--k];
+        }
+    }
+};
+
+/**
+ * @brief Buffered writer of the binary edge list read by load_binary_edges.
+ *
+ * The edge count is patched into the header by end(), so the file must be seekable.
+ */
+class BinaryEdgeWriter
+{
+public:
+    BinaryEdgeWriter(FILE *file) : file(file), used(0), m(0) {}
+    ~BinaryEdgeWriter() { flush(); }
+
+    void begin(int n, int source, int sink, long long expected)
+    {
+        EdgeListHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(header.magic, "FFGEDGE", 8);
+        header.version = EDGE_LIST_VERSION;
+        header.byte_order = 0x01020304;
+        header.n = n;
+        header.source = source;
+        header.sink = sink;
+        fwrite(&header, sizeof(header), 1, file);
+        (void)expected;
+    }
+
+    void edge(int u, int v, int capacity)
+    {
+        if (used + 3 > BUFFERED)
+        {
+            flush();
+        }
+        buffer[used++] = u;
+        buffer[used++] = v;
+        buffer[used++] = capacity;
+        m++;
+    }
+
+    void end()
+    {
+        flush();
+        fseek(file, offsetof(EdgeListHeader, m), SEEK_SET);
+        fwrite(&m, sizeof(m), 1, file);
+        fseek(file, 0, SEEK_END);
+    }
+
+    void flush()
+    {
+        fwrite(buffer, sizeof(int32_t), used, file);
+        used = 0;
+    }
+
+private:
+    static const size_t BUFFERED = 3 * 8192;
+    FILE *file;
+    size_t used;
+    int64_t m;
+    int32_t buffer[BUFFERED];
+};
+
+#endif
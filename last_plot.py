@@ -1,15 +1,32 @@
+import csv
+import sys
 import matplotlib.pyplot as plt
 
-# input test case sizes and times (in microseconds)
-test_sizes = [20,40,50,100,400,500,1000]
-test_times = [1847,5915,3768,9111,181852,374474,2129160]
+# results of `./benchmark --output benchmark.csv`, optionally followed by the family to plot
+path = sys.argv[1] if len(sys.argv) > 1 else "benchmark.csv"
+family = sys.argv[2] if len(sys.argv) > 2 else "sparse"
 
-# create a line chart with test_sizes on the x-axis and test_times on the y-axis
-plt.plot(test_sizes, test_times, '-o')
+# median solve time (in microseconds) of every engine against the number of edges,
+# the parallel engines (parallel and auction) once per thread count of a --threads sweep
+series = {}
+with open(path) as f:
+    for row in csv.DictReader(f):
+        if row["family"] == family and row["status"] == "ok":
+            name = row["engine"] if row["engine"] not in ("parallel", "auction") else row["engine"] + " x" + row["threads"]
+            series.setdefault(name, []).append((int(row["m"]), float(row["solve_median_us"])))
+
+# one line per engine with the edge counts on the x-axis and the times on the y-axis
+for engine, points in series.items():
+    points.sort()
+    plt.plot([m for m, _ in points], [t for _, t in points], '-o', label=engine)
 
 # set the labels for the x-axis and y-axis
-plt.xlabel('Number of Points')
-plt.ylabel('Time (microseconds)')
+plt.xscale('log')
+plt.yscale('log')
+plt.xlabel('Number of Edges')
+plt.ylabel('Median solve time (microseconds)')
+plt.title(family)
+plt.legend()
 
 # show the plot
 plt.show()
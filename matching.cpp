@@ -0,0 +1,400 @@
+#include "matching.h"
+#include <climits>
+#include <queue>
+#include <fstream>
+#include <algorithm>
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+BipartiteGraph::BipartiteGraph(int n)
+{
+    this->n = n;
+    words = 0;
+}
+
+void BipartiteGraph::add_edge(int u, int v)
+{
+    edge_list.push_back(make_pair(u, v));
+}
+
+int BipartiteGraph::hopcroft_karp()
+{
+    // lay out the adjacency with a counting sort over the edge list
+    first_adj.assign(n + 1, 0);
+    for (int i = 0; i < (int)edge_list.size(); i++)
+    {
+        first_adj[edge_list[i].first + 1]++;
+    }
+    for (int u = 0; u < n; u++)
+    {
+        first_adj[u + 1] += first_adj[u];
+    }
+    adj.resize(edge_list.size());
+    vector<int> pos(first_adj.begin(), first_adj.end() - 1);
+    for (int i = 0; i < (int)edge_list.size(); i++)
+    {
+        adj[pos[edge_list[i].first]++] = edge_list[i].second;
+    }
+
+    match_left.assign(n, -1);
+    match_right.assign(n, -1);
+    dist.assign(n, 0);
+    current.assign(n, 0);
+
+    // a greedy pass usually matches most vertices before the first phase
+    int matching = 0;
+    for (int u = 0; u < n; u++)
+    {
+        for (int i = first_adj[u]; i < first_adj[u + 1]; i++)
+        {
+            if (match_right[adj[i]] < 0)
+            {
+                match_left[u] = adj[i];
+                match_right[adj[i]] = u;
+                matching++;
+                break;
+            }
+        }
+    }
+
+    vector<int> stack;
+    while (bfs())
+    {
+        for (int u = 0; u < n; u++)
+        {
+            current[u] = first_adj[u];
+        }
+        for (int u = 0; u < n; u++)
+        {
+            if (match_left[u] < 0 && first_adj[u] < first_adj[u + 1] && dfs(u, stack))
+            {
+                matching++;
+            }
+        }
+    }
+    return matching;
+}
+
+bool BipartiteGraph::bfs()
+{
+    queue<int> q;
+    for (int u = 0; u < n; u++)
+    {
+        if (match_left[u] < 0)
+        {
+            dist[u] = 0;
+            q.push(u);
+        }
+        else
+        {
+            dist[u] = INT_MAX;
+        }
+    }
+
+    bool found = false;
+    while (!q.empty())
+    {
+        int u = q.front();
+        q.pop();
+        for (int i = first_adj[u]; i < first_adj[u + 1]; i++)
+        {
+            int w = match_right[adj[i]];
+            if (w < 0)
+            {
+                found = true;
+            }
+            else if (dist[w] == INT_MAX)
+            {
+                dist[w] = dist[u] + 1;
+                q.push(w);
+            }
+        }
+    }
+    return found;
+}
+
+bool BipartiteGraph::dfs(int root, vector<int> &stack)
+{
+    // the stack holds the left vertices of the alternating path, current[u] points at the next right vertex
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        int u = stack.back();
+        if (current[u] == first_adj[u + 1])
+        {
+            // dead end, drop u from this phase
+            dist[u] = INT_MAX;
+            stack.pop_back();
+            if (!stack.empty())
+            {
+                current[stack.back()]++;
+            }
+            continue;
+        }
+
+        int v = adj[current[u]];
+        int w = match_right[v];
+        if (w < 0)
+        {
+            // free right vertex: flip the matching along the path
+            for (int i = 0; i < (int)stack.size(); i++)
+            {
+                int x = stack[i];
+                int y = adj[current[x]];
+                match_left[x] = y;
+                match_right[y] = x;
+            }
+            return true;
+        }
+        if (dist[w] == dist[u] + 1)
+        {
+            stack.push_back(w);
+        }
+        else
+        {
+            current[u]++;
+        }
+    }
+    return false;
+}
+
+// first word j >= from where a, b and c share a bit, words if there is none
+static int first_common_word(const uint64_t *a, const uint64_t *b, const uint64_t *c, int from, int words)
+{
+    int j = from;
+#if defined(__AVX512F__)
+    for (; j + 8 <= words; j += 8)
+    {
+        __m512i ab = _mm512_and_si512(_mm512_loadu_si512(a + j), _mm512_loadu_si512(b + j));
+        __mmask8 hit = _mm512_test_epi64_mask(ab, _mm512_loadu_si512(c + j));
+        if (hit)
+        {
+            return j + __builtin_ctz(hit);
+        }
+    }
+#elif defined(__AVX2__)
+    for (; j + 4 <= words; j += 4)
+    {
+        __m256i ab = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(a + j)), _mm256_loadu_si256((const __m256i *)(b + j)));
+        __m256i c4 = _mm256_loadu_si256((const __m256i *)(c + j));
+        if (!_mm256_testz_si256(ab, c4))
+        {
+            break;
+        }
+    }
+#endif
+    for (; j < words; j++)
+    {
+        if (a[j] & b[j] & c[j])
+        {
+            return j;
+        }
+    }
+    return words;
+}
+
+bool BipartiteGraph::is_dense() const
+{
+    // an edge per 16 bits keeps a word scan cheaper than the adjacency, and the rows under 1 GB
+    long long bits = (long long)n * n;
+    return n > 0 && (long long)edge_list.size() * 16 >= bits && bits <= (1LL << 33);
+}
+
+int BipartiteGraph::dense_matching()
+{
+    words = (n + 63) / 64;
+    rows.assign((size_t)n * words, 0);
+    for (int i = 0; i < (int)edge_list.size(); i++)
+    {
+        int u = edge_list[i].first, v = edge_list[i].second;
+        rows[(size_t)u * words + v / 64] |= 1ULL << (v % 64);
+    }
+    match_left.assign(n, -1);
+    match_right.assign(n, -1);
+    current.assign(n, 0);
+    via.assign(n, -1);
+    unvisited.assign(words, 0);
+    for (int v = 0; v < n; v++)
+    {
+        unvisited[v / 64] |= 1ULL << (v % 64);
+    }
+    vector<uint64_t> all(unvisited);
+
+    // greedy pass, unvisited holds the free right vertices here
+    int matching = 0;
+    for (int u = 0; u < n; u++)
+    {
+        const uint64_t *row = &rows[(size_t)u * words];
+        int j = first_common_word(row, unvisited.data(), row, 0, words);
+        if (j < words)
+        {
+            int v = j * 64 + __builtin_ctzll(row[j] & unvisited[j]);
+            unvisited[j] &= ~(1ULL << (v % 64));
+            match_left[u] = v;
+            match_right[v] = u;
+            matching++;
+        }
+    }
+
+    vector<int> stack;
+    int depth;
+    while (dense_bfs(depth))
+    {
+        unvisited = all;
+        for (int u = 0; u < n; u++)
+        {
+            current[u] = 0;
+        }
+        for (int u = 0; u < n; u++)
+        {
+            if (match_left[u] < 0 && dense_dfs(u, depth, stack))
+            {
+                matching++;
+            }
+        }
+    }
+    return matching;
+}
+
+bool BipartiteGraph::dense_bfs(int &depth)
+{
+    for (int j = 0; j < words; j++)
+    {
+        unvisited[j] = ~0ULL;
+    }
+    if (n % 64)
+    {
+        unvisited[words - 1] = (1ULL << (n % 64)) - 1;
+    }
+    vector<int> frontier, next;
+    for (int u = 0; u < n; u++)
+    {
+        if (match_left[u] < 0)
+        {
+            frontier.push_back(u);
+        }
+    }
+
+    // one layer at a time, every right vertex joins the layer of the first row that reaches it
+    for (depth = 0; !frontier.empty(); depth++)
+    {
+        if ((int)layers.size() < (depth + 1) * words)
+        {
+            layers.resize((size_t)(depth + 1) * words);
+        }
+        uint64_t *layer = &layers[(size_t)depth * words];
+        fill(layer, layer + words, 0);
+        bool found = false;
+        next.clear();
+        for (int i = 0; i < (int)frontier.size(); i++)
+        {
+            const uint64_t *row = &rows[(size_t)frontier[i] * words];
+            for (int j = first_common_word(row, unvisited.data(), row, 0, words); j < words;
+                 j = first_common_word(row, unvisited.data(), row, j + 1, words))
+            {
+                uint64_t x = row[j] & unvisited[j];
+                unvisited[j] &= ~x;
+                layer[j] |= x;
+                for (; x; x &= x - 1)
+                {
+                    int w = match_right[j * 64 + __builtin_ctzll(x)];
+                    if (w < 0)
+                    {
+                        found = true;
+                    }
+                    else
+                    {
+                        next.push_back(w);
+                    }
+                }
+            }
+        }
+        if (found)
+        {
+            return true;
+        }
+        frontier.swap(next);
+    }
+    return false;
+}
+
+bool BipartiteGraph::dense_dfs(int root, int depth, vector<int> &stack)
+{
+    // the stack position of a left vertex is its layer, current[u] is the first word of row u still worth a look
+    stack.clear();
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        int k = (int)stack.size() - 1;
+        int u = stack.back();
+        const uint64_t *row = &rows[(size_t)u * words];
+        const uint64_t *layer = &layers[(size_t)k * words];
+        int j = first_common_word(row, unvisited.data(), layer, current[u], words);
+        current[u] = j;
+        if (j == words)
+        {
+            // dead end, its right vertices stay visited for the rest of the phase
+            stack.pop_back();
+            continue;
+        }
+
+        int v = j * 64 + __builtin_ctzll(row[j] & unvisited[j] & layer[j]);
+        unvisited[j] &= ~(1ULL << (v % 64));
+        via[u] = v;
+        int w = match_right[v];
+        if (w < 0)
+        {
+            // free right vertex: flip the matching along the path
+            for (int i = 0; i < (int)stack.size(); i++)
+            {
+                match_left[stack[i]] = via[stack[i]];
+                match_right[via[stack[i]]] = stack[i];
+            }
+            return true;
+        }
+        if (k < depth)
+        {
+            stack.push_back(w);
+        }
+    }
+    return false;
+}
+
+vector<pair<int, int>> BipartiteGraph::matched_pairs()
+{
+    vector<pair<int, int>> pairs;
+    for (int u = 0; u < (int)match_left.size(); u++)
+    {
+        if (match_left[u] >= 0)
+        {
+            pairs.push_back(make_pair(u, match_left[u]));
+        }
+    }
+    return pairs;
+}
+
+bool load_bipartite(const string &path, BipartiteGraph &G, string &error)
+{
+    ifstream infile(path.c_str());
+    int n;
+    if (!(infile >> n) || n < 0)
+    {
+        error = path + ": expected the vertex count";
+        return false;
+    }
+    G = BipartiteGraph(n);
+    //now user enters the edges, u from set U and v from set V
+    int u, v;
+    while (infile >> u >> v)
+    {
+        if (u < 0 || u >= n || v < 0 || v >= n)
+        {
+            error = path + ": vertex out of range";
+            return false;
+        }
+        G.add_edge(u, v);
+    }
+    return true;
+}
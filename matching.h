@@ -0,0 +1,95 @@
+#ifndef MATCHING_H
+#define MATCHING_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+using namespace std;
+
+/**
+ * @brief Bipartite graph given as left-to-right adjacency, matched with Hopcroft-Karp.
+ *
+ * Left and right vertices live in separate id spaces [0, n), so a vertex id may appear on
+ * both sides without the two being confused.
+ */
+class BipartiteGraph
+{
+public:
+    int n;                             // number of vertex ids on each side
+    vector<pair<int, int>> edge_list;  // (left, right) pairs in the order they were added
+
+    // Compressed adjacency, the right neighbours of u are adj[first_adj[u]] .. adj[first_adj[u + 1] - 1]
+    vector<int> first_adj;
+    vector<int> adj;
+
+    vector<int> match_left;  // right partner of every left vertex, -1 if free
+    vector<int> match_right; // left partner of every right vertex, -1 if free
+    vector<int> dist;        // BFS layer of every left vertex in the current phase
+    vector<int> current;     // next adjacency slot to try for every left vertex
+
+    // Dense mode: bit v of row u is set when (u, v) is an edge, every row is `words` 64-bit words
+    int words;
+    vector<uint64_t> rows;
+    vector<uint64_t> unvisited; // right vertices not reached yet in the current BFS or DFS
+    vector<uint64_t> layers;    // row k holds the right vertices the BFS reached from layer k
+    vector<int> via;            // right vertex each left vertex on the DFS stack continues through
+
+    // constructor to initialize the graph
+    BipartiteGraph(int n);
+
+    // method to add an edge between left vertex u and right vertex v
+    void add_edge(int u, int v);
+
+    /**
+     * @brief Calculates a maximum matching with Hopcroft-Karp.
+     *
+     * Every phase layers the left vertices by BFS from the free ones and then augments a
+     * maximal set of vertex-disjoint shortest augmenting paths, so at most O(sqrt(V)) phases
+     * of O(E) work are needed.
+     *
+     * @return The size of the matching.
+     */
+    int hopcroft_karp();
+
+    // method to layer the left vertices, true if some free right vertex is reachable
+    bool bfs();
+
+    // method to find an augmenting path from the free left vertex root along the layers
+    bool dfs(int root, vector<int> &stack);
+
+    /**
+     * @brief Calculates a maximum matching with Hopcroft-Karp on bitset adjacency rows.
+     *
+     * Meant for dense instances, where n * n / 8 bytes of bits are smaller than the edge
+     * list. The BFS reaches a whole word of right vertices per AND of an adjacency row with
+     * the unvisited set, and the DFS skips 64 right vertices per word (256 or 512 with AVX2
+     * or AVX-512) that are adjacent, unvisited and on the next layer.
+     *
+     * @return The size of the matching.
+     */
+    int dense_matching();
+
+    // method to layer the left vertices over the bitset rows, true if some free right vertex is reachable
+    bool dense_bfs(int &depth);
+
+    // method to find an augmenting path from the free left vertex root over the bitset rows
+    bool dense_dfs(int root, int depth, vector<int> &stack);
+
+    // method to tell if the edge count makes the bitset rows the better representation
+    bool is_dense() const;
+
+    // method to list the matched (left, right) pairs
+    vector<pair<int, int>> matched_pairs();
+};
+
+/**
+ * @brief Loads a bipartite graph in the inputBipartite.txt format: n, then one `u v` edge per line.
+ *
+ * @param path The file to read.
+ * @param G Receives the graph.
+ * @param error Receives the reason on failure.
+ * @return true on success.
+ */
+bool load_bipartite(const string &path, BipartiteGraph &G, string &error);
+
+#endif
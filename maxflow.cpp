@@ -0,0 +1,2799 @@
+#include "maxflow.h"
+#include <iostream>
+#include <queue>
+#include <fstream>
+#include <thread>
+#include <cstdlib>
+#include <new>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <chrono>
+
+/**
+ * @brief Adds the lifetime of a scope to a FlowStats timer, or does nothing without FLOW_STATS.
+ */
+struct StatsTimer
+{
+#ifdef FLOW_STATS
+    double &total;
+    chrono::steady_clock::time_point start;
+
+    StatsTimer(double &total) : total(total), start(chrono::steady_clock::now()) {}
+    ~StatsTimer() { total += chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count() / 1000.0; }
+#else
+    StatsTimer(double &) {}
+#endif
+};
+
+void FlowStats::reset()
+{
+    augmentations = searches = vertices_visited = max_visited = search_visited = arcs_scanned = 0;
+    residual_rebuilds = residual_syncs = phases = pushes = relabels = global_relabels = gaps = repair_paths = 0;
+    fill(bottleneck, bottleneck + 64, 0LL);
+    load_us = solve_us = cut_us = 0;
+}
+
+void FlowStats::record_augmentation(long long bottleneck_capacity)
+{
+    augmentations++;
+    int bucket = 0;
+    while (bottleneck_capacity > 1)
+    {
+        bottleneck_capacity >>= 1;
+        bucket++;
+    }
+    bottleneck[bucket]++;
+}
+
+string FlowStats::to_json() const
+{
+#ifdef FLOW_STATS
+    bool enabled = true;
+#else
+    bool enabled = false;
+#endif
+    // bottleneck buckets up to the last non-empty one, bucket b counts bottlenecks in [2^b, 2^(b+1))
+    int buckets = 64;
+    while (buckets > 0 && bottleneck[buckets - 1] == 0)
+    {
+        buckets--;
+    }
+    string histogram;
+    for (int b = 0; b < buckets; b++)
+    {
+        histogram += (b ? ", " : "") + to_string(bottleneck[b]);
+    }
+    char timers[160];
+    snprintf(timers, sizeof(timers), "\"load_us\": %.1f, \"solve_us\": %.1f, \"cut_us\": %.1f", load_us, solve_us, cut_us);
+    return string("{\"enabled\": ") + (enabled ? "true" : "false") +
+           ", \"augmentations\": " + to_string(augmentations) +
+           ", \"bottleneck_log2_histogram\": [" + histogram + "]" +
+           ", \"searches\": " + to_string(searches) +
+           ", \"vertices_visited\": " + to_string(vertices_visited) +
+           ", \"max_visited_per_search\": " + to_string(max_visited) +
+           ", \"arcs_scanned\": " + to_string(arcs_scanned) +
+           ", \"residual_rebuilds\": " + to_string(residual_rebuilds) +
+           ", \"residual_syncs\": " + to_string(residual_syncs) +
+           ", \"phases\": " + to_string(phases) +
+           ", \"pushes\": " + to_string(pushes) +
+           ", \"relabels\": " + to_string(relabels) +
+           ", \"global_relabels\": " + to_string(global_relabels) +
+           ", \"gaps\": " + to_string(gaps) +
+           ", \"repair_paths\": " + to_string(repair_paths) +
+           ", " + timers + "}";
+}
+
+Arena::Arena()
+{
+    block = 0;
+    used = 0;
+}
+
+Arena::~Arena()
+{
+    release();
+}
+
+void *Arena::allocate_bytes(size_t bytes, size_t align)
+{
+    const size_t min_block = 1 << 20;
+    while (block < blocks.size())
+    {
+        size_t start = (used + align - 1) & ~(align - 1);
+        if (start + bytes <= blocks[block].second)
+        {
+            used = start + bytes;
+            return blocks[block].first + start;
+        }
+        block++;
+        used = 0;
+    }
+    size_t size = max(min_block, bytes + align);
+    blocks.push_back(make_pair(static_cast<char *>(::operator new(size)), size));
+    block = blocks.size() - 1;
+    used = 0;
+    return allocate_bytes(bytes, align);
+}
+
+void Arena::reset()
+{
+    block = 0;
+    used = 0;
+}
+
+void Arena::release()
+{
+    for (size_t i = 0; i < blocks.size(); i++)
+    {
+        ::operator delete(blocks[i].first);
+    }
+    blocks.clear();
+    reset();
+}
+
+template <class Cap>
+BasicGraph<Cap>::BasicGraph(int n)
+{
+    algorithm = FORD_FULKERSON;
+    cost_algorithm = SUCCESSIVE_SHORTEST_PATHS;
+    threads = max(1u, thread::hardware_concurrency());
+    capacity_scaling = false;
+    visit_epoch = 0;
+    mapping = nullptr;
+    mapping_size = 0;
+    arc_cap = arc_flow = nullptr;
+    arc_bits = nullptr;
+    reset(n);
+}
+
+template <class Cap>
+BasicGraph<Cap>::~BasicGraph()
+{
+    if (mapping)
+    {
+        munmap(mapping, mapping_size);
+    }
+}
+/**
+     * @brief Empties the graph for reuse with n vertices.
+     *
+     * @param n The number of vertices of the next graph.
+     */
+template <class Cap>
+void BasicGraph<Cap>::reset(int n)
+{
+    arena.reset();
+    if (mapping)
+    {
+        munmap(mapping, mapping_size);
+        mapping = nullptr;
+        mapping_size = 0;
+    }
+    this->n = n;
+    m = 0;
+    edges = nullptr;
+    edge_cost.clear();
+    stats.reset();
+    solved_source = solved_sink = -1;
+    solved_preflow = false;
+    flow_source = flow_sink = -1;
+    imbalance.clear();
+    unbalanced.clear();
+    edge_room = 0;
+    arc_room = 0;
+    first_arc = arena.allocate<int>(n + 1);
+    fill(first_arc, first_arc + n + 1, 0);
+    csr_ready = true;
+}
+/**
+     * @brief Makes room for at least m edges in total.
+     *
+     * @param m The number of edges the graph will hold.
+     */
+template <class Cap>
+void BasicGraph<Cap>::reserve_edges(int m)
+{
+    if (m <= edge_room)
+    {
+        return;
+    }
+    // the old array stays in the arena until the next reset
+    BasicEdge<Cap> *moved = arena.allocate<BasicEdge<Cap>>(m);
+    for (int i = 0; i < this->m; i++)
+    {
+        new (&moved[i]) BasicEdge<Cap>(edges[i]);
+    }
+    edges = moved;
+    edge_room = m;
+}
+/**
+     * @brief Add an edge to the graph with the given source, destination, and capacity.
+     *
+     * @param u The source vertex of the edge.
+     * @param v The destination vertex of the edge.
+     * @param capacity The capacity of the edge.
+     * @return The index of the new edge.
+     */
+template <class Cap>
+int BasicGraph<Cap>::add_edge(int u, int v, Cap capacity, long long cost)
+{
+    if (m == edge_room)
+    {
+        reserve_edges(max(16, 2 * m));
+    }
+    new (&edges[m]) BasicEdge<Cap>(u, v, capacity);
+    // costs are only stored once some edge has one
+    if (cost != 0 || !edge_cost.empty())
+    {
+        edge_cost.resize(m, 0);
+        edge_cost.push_back(cost);
+    }
+    m++;
+    csr_ready = false;
+    solved_source = solved_sink = -1;
+    return m - 1;
+}
+/**
+     * @brief Changes the capacity of an edge, dropping the flow that no longer fits.
+     *
+     * @param edge The index of the edge.
+     * @param capacity The new capacity, at least 0.
+     */
+template <class Cap>
+void BasicGraph<Cap>::set_capacity(int edge, Cap capacity)
+{
+    BasicEdge<Cap> &e = edges[edge];
+    e.capacity = capacity;
+    solved_source = solved_sink = -1;
+    Flow dropped = e.flow > capacity ? e.flow - capacity : 0;
+    e.flow -= dropped;
+    if (csr_ready)
+    {
+        set_arc(edge_arc[edge], e.capacity, e.flow);
+    }
+    if (dropped == 0)
+    {
+        return;
+    }
+
+    // the tail now receives more than it sends and the head sends more than it receives
+    if ((int)imbalance.size() != n)
+    {
+        imbalance.assign(n, 0);
+    }
+    imbalance[e.u] += dropped;
+    imbalance[e.v] -= dropped;
+    unbalanced.push_back(e.u);
+    unbalanced.push_back(e.v);
+}
+/**
+     * @brief Removes an edge by setting its capacity to 0.
+     *
+     * @param edge The index of the edge.
+     */
+template <class Cap>
+void BasicGraph<Cap>::remove_edge(int edge)
+{
+    set_capacity(edge, 0);
+}
+/**
+     * @brief Lays out the forward and reverse arcs of every edge in compressed sparse row order.
+     */
+template <class Cap>
+void BasicGraph<Cap>::build_csr()
+{
+    fill(first_arc, first_arc + n + 1, 0);
+    for (int i = 0; i < m; i++)
+    {
+        first_arc[edges[i].u + 1]++;
+        first_arc[edges[i].v + 1]++;
+    }
+    for (int u = 0; u < n; u++)
+    {
+        first_arc[u + 1] += first_arc[u];
+    }
+
+    if (2 * m > arc_room)
+    {
+        arc_room = 2 * m;
+        arc_head = arena.allocate<int>(arc_room);
+        arc_rev = arena.allocate<int>(arc_room);
+        arc_edge = arena.allocate<int>(arc_room);
+        if (CapacityTraits<Cap>::unit)
+        {
+            arc_bits = arena.allocate<uint64_t>((arc_room + 63) / 64);
+        }
+        else
+        {
+            arc_cap = arena.allocate<Cap>(arc_room);
+            arc_flow = arena.allocate<Cap>(arc_room);
+        }
+        edge_arc = arena.allocate<int>(m);
+    }
+
+    // next free arc slot of every vertex
+    vector<int> pos(first_arc, first_arc + n);
+    for (int i = 0; i < m; i++)
+    {
+        BasicEdge<Cap> *e = &edges[i];
+        int a = pos[e->u]++;
+        int b = pos[e->v]++;
+        arc_head[a] = e->v;
+        arc_head[b] = e->u;
+        arc_rev[a] = b;
+        arc_rev[b] = a;
+        arc_edge[a] = i;
+        arc_edge[b] = ~i;
+        edge_arc[i] = a;
+        set_arc(a, e->capacity, e->flow);
+    }
+    csr_ready = true;
+    FLOW_STAT(stats.residual_rebuilds++);
+}
+ /**
+     * @brief Refreshes the residual capacities of all arcs from the flow stored in the edges.
+     */
+template <class Cap>
+void BasicGraph<Cap>::create_residual_graph()
+{
+    if (!csr_ready)
+    {
+        build_csr();
+        return;
+    }
+    FLOW_STAT(stats.residual_syncs++);
+    for (int i = 0; i < m; i++)
+    {
+        set_arc(edge_arc[i], edges[i].capacity, edges[i].flow);
+    }
+}
+/**
+     * @brief Starts a new search: every vertex becomes unvisited in O(1).
+     *
+     * The marks are only cleared when the graph changed size or the epoch counter wraps.
+     */
+template <class Cap>
+void BasicGraph<Cap>::start_search()
+{
+    if ((int)visit_mark.size() != n)
+    {
+        visit_mark.assign(n, 0);
+        parent_arc.resize(n);
+        search_cursor.resize(n);
+        visit_epoch = 0;
+    }
+    if (++visit_epoch == 0)
+    {
+        fill(visit_mark.begin(), visit_mark.end(), 0);
+        visit_epoch = 1;
+    }
+    FLOW_STAT(stats.searches++; stats.search_visited = 0);
+}
+/**
+     * @brief Performs a depth-first search (DFS) to find an augmenting path in the residual graph.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param delta The smallest residual capacity an arc on the path may have.
+     * @return true if an augmenting path is found, false otherwise.
+     */
+template <class Cap>
+bool BasicGraph<Cap>::dfs(int source, int sink, typename BasicGraph<Cap>::Flow delta)
+{
+    start_search();
+    search_stack.clear();
+    mark_visited(source);
+    search_cursor[source] = first_arc[source];
+    search_stack.push_back(source);
+    while (!search_stack.empty())
+    {
+        int u = search_stack.back();
+
+        // If u is the sink, the stack is the path
+        if (u == sink)
+        {
+            return true;
+        }
+
+        // Skip arcs to visited vertices and arcs with too little residual capacity
+        int &a = search_cursor[u];
+        while (a < first_arc[u + 1] && (is_visited(arc_head[a]) || residual(a) < delta))
+        {
+            FLOW_STAT(stats.arcs_scanned++);
+            a++;
+        }
+        if (a == first_arc[u + 1])
+        {
+            // No augmenting path through u
+            search_stack.pop_back();
+            continue;
+        }
+
+        // Descend into v and remember the arc that reached it
+        FLOW_STAT(stats.arcs_scanned++);
+        int v = arc_head[a++];
+        parent_arc[v] = search_cursor[u] - 1;
+        mark_visited(v);
+        search_cursor[v] = first_arc[v];
+        search_stack.push_back(v);
+    }
+
+    // If no augmenting path is found from the source, return false
+    return false;
+}
+/**
+     * @brief Performs a breadth-first search (BFS) to find a shortest augmenting path in the residual graph.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param delta The smallest residual capacity an arc on the path may have.
+     * @return true if an augmenting path is found, false otherwise. The path is left in parent_arc.
+     */
+template <class Cap>
+bool BasicGraph<Cap>::bfs(int source, int sink, typename BasicGraph<Cap>::Flow delta)
+{
+    start_search();
+    search_stack.clear();
+    mark_visited(source);
+    search_stack.push_back(source);
+    for (int head = 0; head < (int)search_stack.size(); head++)
+    {
+        int u = search_stack[head];
+        FLOW_STAT(stats.arcs_scanned += first_arc[u + 1] - first_arc[u]);
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+        {
+            int v = arc_head[a];
+            if (!is_visited(v) && residual(a) >= delta)
+            {
+                parent_arc[v] = a;
+                mark_visited(v);
+                if (v == sink)
+                {
+                    return true;
+                }
+                search_stack.push_back(v);
+            }
+        }
+    }
+    return false;
+}
+/**
+     * @brief Finds an augmenting path in the residual graph.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param delta The smallest residual capacity an arc on the path may have.
+     * @return true if a path was found, parent_arc then holds it.
+     */
+template <class Cap>
+bool BasicGraph<Cap>::find_augmenting_path(int source, int sink, typename BasicGraph<Cap>::Flow delta)
+{
+    if (algorithm == EDMONDS_KARP)
+    {
+        return bfs(source, sink, delta);
+    }
+    return dfs(source, sink, delta);
+}
+/**
+     * @brief Calculates the maximum flow in the graph with the engine chosen in `algorithm`.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The maximum flow in the graph.
+     */
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::max_flow(int source, int sink)
+{
+    if (source == sink)
+    {
+        // no flow leaves a source that is its own sink, and no search could end at it
+        return 0;
+    }
+    StatsTimer timer(stats.solve_us);
+    start_flow(source, sink);
+    repair_flow(source, sink);
+    solved_source = source;
+    solved_sink = sink;
+    solved_preflow = false;
+    if (algorithm == DINIC)
+    {
+        return dinic(source, sink);
+    }
+    if (algorithm == PUSH_RELABEL)
+    {
+        return push_relabel(source, sink, true);
+    }
+    if (algorithm == PARALLEL_PUSH_RELABEL)
+    {
+        return parallel_push_relabel(source, sink, true);
+    }
+    return ford_fulkerson(source, sink);
+}
+template <class Cap>
+void BasicGraph<Cap>::start_flow(int source, int sink)
+{
+    if (flow_source == source && flow_sink == sink)
+    {
+        return;
+    }
+    if (flow_source >= 0)
+    {
+        for (int i = 0; i < m; i++)
+        {
+            edges[i].flow = 0;
+        }
+        for (int i = 0; i < (int)unbalanced.size(); i++)
+        {
+            imbalance[unbalanced[i]] = 0;
+        }
+        unbalanced.clear();
+    }
+    flow_source = source;
+    flow_sink = sink;
+}
+/**
+     * @brief Routes the surplus and deficit left by capacity decreases until every vertex but the source and sink is balanced.
+     *
+     * Surplus vertices go first and may send to a deficit vertex, which keeps the flow value,
+     * or to the source or sink. The deficits that are left pull from the source or sink.
+     * Both searches always succeed: flow into a surplus vertex traces back to the source or a
+     * deficit, and flow out of a deficit vertex traces forward to the sink.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     */
+template <class Cap>
+void BasicGraph<Cap>::repair_flow(int source, int sink)
+{
+    if (unbalanced.empty())
+    {
+        return;
+    }
+    create_residual_graph();
+    for (int forward = 1; forward >= 0; forward--)
+    {
+        for (int i = 0; i < (int)unbalanced.size(); i++)
+        {
+            int u = unbalanced[i];
+            if (u == source || u == sink)
+            {
+                continue;
+            }
+            while ((forward ? imbalance[u] > 0 : imbalance[u] < 0) && repair_path(u, source, sink, forward))
+            {
+            }
+        }
+    }
+    for (int i = 0; i < (int)unbalanced.size(); i++)
+    {
+        imbalance[unbalanced[i]] = 0;
+    }
+    unbalanced.clear();
+    store_edge_flows();
+}
+/**
+     * @brief Moves flow along one residual path between an unbalanced vertex and a vertex that can absorb it.
+     *
+     * @param from The unbalanced vertex.
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param forward true to send surplus out of `from`, false to pull flow into a deficit at `from`.
+     * @return true if a path was found and flow moved along it.
+     */
+template <class Cap>
+bool BasicGraph<Cap>::repair_path(int from, int source, int sink, bool forward)
+{
+    start_search();
+    search_stack.clear();
+    mark_visited(from);
+    search_cursor[from] = first_arc[from];
+    search_stack.push_back(from);
+    int target = -1;
+    while (!search_stack.empty())
+    {
+        int u = search_stack.back();
+        if (u != from && (u == source || u == sink || (forward && imbalance[u] < 0)))
+        {
+            target = u;
+            break;
+        }
+
+        // forward searches follow residual arcs out of u, backward searches residual arcs into u
+        int &a = search_cursor[u];
+        while (a < first_arc[u + 1] && (is_visited(arc_head[a]) || residual(forward ? a : arc_rev[a]) <= 0))
+        {
+            FLOW_STAT(stats.arcs_scanned++);
+            a++;
+        }
+        if (a == first_arc[u + 1])
+        {
+            search_stack.pop_back();
+            continue;
+        }
+        FLOW_STAT(stats.arcs_scanned++);
+        int v = arc_head[a];
+        parent_arc[v] = forward ? a : arc_rev[a];
+        a++;
+        mark_visited(v);
+        search_cursor[v] = first_arc[v];
+        search_stack.push_back(v);
+    }
+    if (target < 0)
+    {
+        return false;
+    }
+
+    // walk the path back to `from`: forward paths end in the arc's head, backward paths start at its tail
+    Flow amount = forward ? imbalance[from] : -imbalance[from];
+    if (forward && target != source && target != sink)
+    {
+        amount = min(amount, -imbalance[target]);
+    }
+    for (int v = target; v != from;)
+    {
+        int a = parent_arc[v];
+        amount = min(amount, residual(a));
+        v = forward ? arc_head[arc_rev[a]] : arc_head[a];
+    }
+    for (int v = target; v != from;)
+    {
+        int a = parent_arc[v];
+        push_flow(a, amount);
+        v = forward ? arc_head[arc_rev[a]] : arc_head[a];
+    }
+    if (forward)
+    {
+        imbalance[from] -= amount;
+        if (target != source && target != sink)
+        {
+            imbalance[target] += amount;
+        }
+    }
+    else
+    {
+        imbalance[from] += amount;
+    }
+    FLOW_STAT(stats.repair_paths++);
+    return true;
+}
+/**
+     * @brief Calculates the value of a minimum s-t cut, stopping push-relabel after its preflow phase.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The capacity of a minimum s-t cut.
+     */
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::min_cut_value(int source, int sink)
+{
+    if (source == sink || (algorithm != PUSH_RELABEL && algorithm != PARALLEL_PUSH_RELABEL))
+    {
+        return max_flow(source, sink);
+    }
+    StatsTimer timer(stats.solve_us);
+    start_flow(source, sink);
+    repair_flow(source, sink);
+    solved_source = source;
+    solved_sink = sink;
+    solved_preflow = true;
+    if (algorithm == PUSH_RELABEL)
+    {
+        return push_relabel(source, sink, false);
+    }
+    return parallel_push_relabel(source, sink, false);
+}
+/**
+     * @brief Calculates the maximum flow in the graph using the Ford-Fulkerson algorithm.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The maximum flow in the graph.
+     */
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::ford_fulkerson(int source, int sink)
+{
+    // the arcs are synchronised with the edges once, afterwards every augmentation updates them in place
+    create_residual_graph();
+    Flow max_flow = flow_value(source); // a stored flow is kept and augmented
+
+    Flow delta = 1;
+    if (capacity_scaling)
+    {
+        Flow largest = 0;
+        for (int i = 0; i < m; i++)
+        {
+            largest = max(largest, (Flow)edges[i].capacity);
+        }
+        while (delta <= largest / 2)
+        {
+            delta *= 2;
+        }
+    }
+    while (true)
+    {
+        if (!find_augmenting_path(source, sink, delta))
+        {
+            // no path carries delta any more, move on to the next scaling phase
+            if (delta > 1)
+            {
+                delta /= 2;
+                FLOW_STAT(stats.phases++);
+                continue;
+            }
+            break;
+        }
+        const vector<int> &augmenting_path = parent_arc;
+
+        // the tail of the arc entering v is the head of its reverse arc
+        Flow path_flow = numeric_limits<Flow>::max();
+        for (int v = sink; v != source; v = arc_head[arc_rev[augmenting_path[v]]])
+        {
+            path_flow = min(path_flow, residual(augmenting_path[v])); // finding the bottleneck capacity
+        }
+        FLOW_STAT(stats.record_augmentation(path_flow));
+        // for the particular augmented edge selected we change the flow of the edges in the acutal graph.
+        for (int v = sink; v != source; v = arc_head[arc_rev[augmenting_path[v]]])
+        {
+            int a = augmenting_path[v];
+            push_flow(a, path_flow);
+
+            int e = arc_edge[a];
+            if (e < 0)
+            {
+                edges[~e].flow -= path_flow; // backward arc: cancel flow on the original edge
+            }
+            else
+            {
+                edges[e].flow += path_flow;
+            }
+        }
+        max_flow += path_flow;
+    }
+
+    return max_flow;
+}
+/**
+     * @brief Calculates the maximum flow with Dinic's algorithm.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The maximum flow in the graph.
+     */
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::dinic(int source, int sink)
+{
+    create_residual_graph();
+    vector<int> level(n), current(n);
+
+    Flow max_flow = flow_value(source);
+    while (build_levels(source, sink, level))
+    {
+        FLOW_STAT(stats.phases++);
+        max_flow += blocking_flow(source, sink, level, current);
+    }
+    store_edge_flows();
+    return max_flow;
+}
+/**
+     * @brief Labels every vertex with its BFS distance from the source in the residual graph.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param level Receives the distance of every vertex, -1 if unreachable.
+     * @return true if the sink is reachable, false otherwise.
+     */
+template <class Cap>
+bool BasicGraph<Cap>::build_levels(int source, int sink, vector<int> &level)
+{
+    fill(level.begin(), level.end(), -1);
+    queue<int> q;
+    level[source] = 0;
+    q.push(source);
+    FLOW_STAT(stats.searches++; stats.vertices_visited++);
+    long long reached = 1;
+    while (!q.empty())
+    {
+        int u = q.front();
+        q.pop();
+        FLOW_STAT(stats.arcs_scanned += first_arc[u + 1] - first_arc[u]);
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+        {
+            int v = arc_head[a];
+            if (level[v] < 0 && residual(a) > 0)
+            {
+                level[v] = level[u] + 1;
+                q.push(v);
+                FLOW_STAT(stats.vertices_visited++; reached++);
+            }
+        }
+    }
+    FLOW_STAT(stats.max_visited = max(stats.max_visited, reached));
+    (void)reached;
+    return level[sink] >= 0;
+}
+/**
+     * @brief Saturates the level graph with a blocking flow.
+     *
+     * Walks forward along admissible arcs with an explicit path stack, so deep level graphs
+     * do not recurse. A vertex whose current arc runs out is cut off from the level graph.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param level The BFS levels of the phase, dead ends are set to -1.
+     * @param current Scratch for the current-arc pointer of every vertex.
+     * @return The flow pushed in this phase.
+     */
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::blocking_flow(int source, int sink, vector<int> &level, vector<int> &current)
+{
+    for (int u = 0; u < n; u++)
+    {
+        current[u] = first_arc[u];
+    }
+
+    Flow pushed = 0;
+    vector<int> path; // arcs from the source to u
+    int u = source;
+    while (true)
+    {
+        if (u == sink)
+        {
+            Flow path_flow = numeric_limits<Flow>::max();
+            for (int i = 0; i < (int)path.size(); i++)
+            {
+                path_flow = min(path_flow, residual(path[i])); // finding the bottleneck capacity
+            }
+            FLOW_STAT(stats.record_augmentation(path_flow));
+            // augment and retreat to the tail of the first saturated arc
+            int retreat = -1;
+            for (int i = 0; i < (int)path.size(); i++)
+            {
+                push_flow(path[i], path_flow);
+                if (retreat < 0 && residual(path[i]) == 0)
+                {
+                    retreat = i;
+                }
+            }
+            pushed += path_flow;
+            path.resize(retreat);
+            u = retreat == 0 ? source : arc_head[path.back()];
+            continue;
+        }
+
+        // advance along the current arc of u
+        int &a = current[u];
+        while (a < first_arc[u + 1] && (residual(a) == 0 || level[arc_head[a]] != level[u] + 1))
+        {
+            FLOW_STAT(stats.arcs_scanned++);
+            a++;
+        }
+        if (a < first_arc[u + 1])
+        {
+            path.push_back(a);
+            u = arc_head[a];
+            continue;
+        }
+
+        // u is a dead end, drop it from the level graph and retreat
+        level[u] = -1;
+        if (path.empty())
+        {
+            break;
+        }
+        u = arc_head[arc_rev[path.back()]];
+        path.pop_back();
+        current[u]++;
+    }
+    return pushed;
+}
+/**
+     * @brief Calculates the maximum flow with highest-label push-relabel.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param convert_to_flow false to stop after the preflow phase.
+     * @return The maximum flow in the graph.
+     */
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::push_relabel(int source, int sink, bool convert_to_flow)
+{
+    create_residual_graph();
+    height.assign(n, n);
+    excess.assign(n, 0);
+    current_arc.assign(n, 0);
+    active_head.assign(n, -1);
+    active_next.assign(n, -1);
+    label_head.assign(n, -1);
+    label_next.assign(n, -1);
+    label_prev.assign(n, -1);
+    init_preflow(source);
+
+    global_relabel(source, sink);
+    long long global_relabel_threshold = 6LL * n + first_arc[n];
+    while (highest_active >= 0)
+    {
+        int u = active_head[highest_active];
+        if (u < 0)
+        {
+            highest_active--;
+            continue;
+        }
+        active_head[highest_active] = active_next[u];
+        discharge(u, sink);
+
+        if (relabel_work > global_relabel_threshold)
+        {
+            global_relabel(source, sink);
+        }
+    }
+
+    if (convert_to_flow)
+    {
+        return_excess(source, sink);
+        store_edge_flows();
+    }
+    return excess[sink];
+}
+/**
+     * @brief Computes the excess left by the flow the edges already carry and saturates the source arcs on top of it.
+     *
+     * @param source The source vertex.
+     */
+template <class Cap>
+void BasicGraph<Cap>::init_preflow(int source)
+{
+    excess.assign(n, 0);
+    for (int u = 0; u < n; u++)
+    {
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+        {
+            excess[u] -= arc_flow_of(a);
+        }
+    }
+    for (int a = first_arc[source]; a < first_arc[source + 1]; a++)
+    {
+        Flow d = residual(a);
+        if (d > 0)
+        {
+            push_flow(a, d);
+            excess[source] -= d;
+            excess[arc_head[a]] += d;
+        }
+    }
+}
+/**
+     * @brief Sets every label to the exact residual distance to the sink by a reverse BFS.
+     *
+     * Vertices that cannot reach the sink get label n and leave phase one. The active and
+     * label buckets are rebuilt from scratch.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     */
+template <class Cap>
+void BasicGraph<Cap>::global_relabel(int source, int sink)
+{
+    fill(height.begin(), height.end(), n);
+    fill(active_head.begin(), active_head.end(), -1);
+    fill(label_head.begin(), label_head.end(), -1);
+    highest_active = highest_label = -1;
+    relabel_work = 0;
+    FLOW_STAT(stats.global_relabels++; stats.arcs_scanned += first_arc[n]);
+
+    queue<int> q;
+    height[sink] = 0;
+    q.push(sink);
+    while (!q.empty())
+    {
+        int u = q.front();
+        q.pop();
+        current_arc[u] = first_arc[u];
+        add_label(u);
+        if (excess[u] > 0 && u != sink)
+        {
+            add_active(u);
+        }
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+        {
+            int v = arc_head[a];
+            // v can push to u if the reverse arc v -> u has residual capacity
+            if (height[v] == n && v != source && residual(arc_rev[a]) > 0)
+            {
+                height[v] = height[u] + 1;
+                q.push(v);
+            }
+        }
+    }
+}
+/**
+     * @brief Pushes the excess of u along admissible arcs, relabeling u whenever it runs out of them.
+     *
+     * @param u The active vertex.
+     * @param sink The sink vertex.
+     */
+template <class Cap>
+void BasicGraph<Cap>::discharge(int u, int sink)
+{
+    while (excess[u] > 0)
+    {
+        if (current_arc[u] == first_arc[u + 1])
+        {
+            relabel(u);
+            if (height[u] >= n)
+            {
+                return;
+            }
+            continue;
+        }
+
+        int a = current_arc[u];
+        int v = arc_head[a];
+        FLOW_STAT(stats.arcs_scanned++);
+        if (residual(a) > 0 && height[u] == height[v] + 1)
+        {
+            Flow d = min(excess[u], residual(a));
+            FLOW_STAT(stats.pushes++);
+            push_flow(a, d);
+            if (excess[v] == 0 && v != sink)
+            {
+                add_active(v);
+            }
+            excess[u] -= d;
+            excess[v] += d;
+        }
+        else
+        {
+            current_arc[u]++;
+        }
+    }
+}
+/**
+     * @brief Lifts u just above its lowest residual neighbour, applying the gap heuristic first.
+     *
+     * If u is the last vertex on its label, no vertex above that label can reach the sink any
+     * more, so all of them (and u) are lifted to n at once.
+     *
+     * @param u The vertex without admissible arcs.
+     */
+template <class Cap>
+void BasicGraph<Cap>::relabel(int u)
+{
+    int old_height = height[u];
+    remove_label(u);
+    FLOW_STAT(stats.relabels++);
+    if (label_head[old_height] < 0)
+    {
+        FLOW_STAT(stats.gaps++);
+        for (int h = old_height + 1; h <= highest_label; h++)
+        {
+            for (int v = label_head[h]; v >= 0; v = label_next[v])
+            {
+                height[v] = n;
+            }
+            label_head[h] = -1;
+            active_head[h] = -1;
+        }
+        highest_label = old_height - 1;
+        height[u] = n;
+        return;
+    }
+
+    int new_height = n;
+    for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+    {
+        if (residual(a) > 0)
+        {
+            new_height = min(new_height, height[arc_head[a]] + 1);
+        }
+    }
+    relabel_work += first_arc[u + 1] - first_arc[u] + 12;
+    FLOW_STAT(stats.arcs_scanned += first_arc[u + 1] - first_arc[u]);
+    height[u] = new_height;
+    current_arc[u] = first_arc[u];
+    if (new_height < n)
+    {
+        add_label(u);
+    }
+}
+/**
+     * @brief Puts u in the active bucket of its label.
+     *
+     * @param u The vertex that just gained excess.
+     */
+template <class Cap>
+void BasicGraph<Cap>::add_active(int u)
+{
+    if (height[u] >= n)
+    {
+        return;
+    }
+    active_next[u] = active_head[height[u]];
+    active_head[height[u]] = u;
+    highest_active = max(highest_active, height[u]);
+}
+/**
+     * @brief Links u into the list of vertices with its label.
+     *
+     * @param u The vertex to link.
+     */
+template <class Cap>
+void BasicGraph<Cap>::add_label(int u)
+{
+    int h = height[u];
+    label_prev[u] = -1;
+    label_next[u] = label_head[h];
+    if (label_head[h] >= 0)
+    {
+        label_prev[label_head[h]] = u;
+    }
+    label_head[h] = u;
+    highest_label = max(highest_label, h);
+}
+/**
+     * @brief Unlinks u from the list of vertices with its label.
+     *
+     * @param u The vertex to unlink.
+     */
+template <class Cap>
+void BasicGraph<Cap>::remove_label(int u)
+{
+    if (label_prev[u] >= 0)
+    {
+        label_next[label_prev[u]] = label_next[u];
+    }
+    else
+    {
+        label_head[height[u]] = label_next[u];
+    }
+    if (label_next[u] >= 0)
+    {
+        label_prev[label_next[u]] = label_prev[u];
+    }
+}
+/**
+     * @brief Turns a maximum preflow into a maximum flow by sending stranded excess back to the source.
+     *
+     * Every vertex with excess can reach the source in the residual graph, so a FIFO push-relabel
+     * with labels measured as distance to the source drains them without touching the sink.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     */
+template <class Cap>
+void BasicGraph<Cap>::return_excess(int source, int sink)
+{
+    const int unreachable = INT_MAX / 2;
+    fill(height.begin(), height.end(), unreachable);
+    queue<int> q;
+    height[source] = 0;
+    q.push(source);
+    while (!q.empty())
+    {
+        int u = q.front();
+        q.pop();
+        current_arc[u] = first_arc[u];
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+        {
+            int v = arc_head[a];
+            if (height[v] == unreachable && v != sink && residual(arc_rev[a]) > 0)
+            {
+                height[v] = height[u] + 1;
+                q.push(v);
+            }
+        }
+    }
+
+    for (int u = 0; u < n; u++)
+    {
+        if (u != source && u != sink && excess[u] > 0)
+        {
+            q.push(u);
+        }
+    }
+    while (!q.empty())
+    {
+        int u = q.front();
+        q.pop();
+        while (excess[u] > 0)
+        {
+            if (current_arc[u] == first_arc[u + 1])
+            {
+                int new_height = unreachable;
+                for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+                {
+                    if (residual(a) > 0)
+                    {
+                        new_height = min(new_height, height[arc_head[a]] + 1);
+                    }
+                }
+                height[u] = new_height;
+                current_arc[u] = first_arc[u];
+                FLOW_STAT(stats.relabels++; stats.arcs_scanned += first_arc[u + 1] - first_arc[u]);
+                continue;
+            }
+            int a = current_arc[u];
+            int v = arc_head[a];
+            if (residual(a) > 0 && height[u] == height[v] + 1)
+            {
+                Flow d = min(excess[u], residual(a));
+                FLOW_STAT(stats.pushes++);
+                push_flow(a, d);
+                if (excess[v] == 0 && v != source && v != sink)
+                {
+                    q.push(v);
+                }
+                excess[u] -= d;
+                excess[v] += d;
+            }
+            else
+            {
+                current_arc[u]++;
+            }
+        }
+    }
+}
+/**
+     * @brief Calculates the maximum flow with a lock-free parallel push-relabel.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param convert_to_flow false to stop after the preflow phase.
+     * @return The maximum flow in the graph.
+     */
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::parallel_push_relabel(int source, int sink, bool convert_to_flow)
+{
+    create_residual_graph();
+    int arcs = first_arc[n];
+    height.assign(n, n);
+    current_arc.assign(n, 0);
+    active_head.assign(n, -1);
+    active_next.assign(n, -1);
+    label_head.assign(n, -1);
+    label_next.assign(n, -1);
+    label_prev.assign(n, -1);
+    init_preflow(source);
+
+    ParallelPushRelabelState<Flow> state;
+    state.flow.reset(new atomic<Flow>[arcs]);
+    state.height.reset(new atomic<int>[n]);
+    state.excess.reset(new atomic<Flow>[n]);
+    state.queued.reset(new atomic<bool>[n]);
+    state.work_limit = 6LL * n + arcs;
+    state.pushes = state.relabels = state.scanned = 0;
+    state.source = source;
+    state.sink = sink;
+
+    while (true)
+    {
+        // epochs are separated by a sequential global relabel on the plain arrays
+        global_relabel(source, sink);
+        state.pool.clear();
+        for (int a = 0; a < arcs; a++)
+        {
+            state.flow[a].store(arc_flow_of(a), memory_order_relaxed);
+        }
+        for (int u = 0; u < n; u++)
+        {
+            state.height[u].store(height[u], memory_order_relaxed);
+            state.excess[u].store(excess[u], memory_order_relaxed);
+            bool active = u != source && u != sink && excess[u] > 0 && height[u] < n;
+            state.queued[u].store(active, memory_order_relaxed);
+            if (active)
+            {
+                state.pool.push_back(u);
+            }
+        }
+        if (state.pool.empty())
+        {
+            break;
+        }
+        state.pending = state.pool.size();
+        state.work = 0;
+        state.stop = false;
+        FLOW_STAT(stats.phases++);
+
+        vector<thread> workers;
+        for (int i = 1; i < threads; i++)
+        {
+            workers.push_back(thread(&BasicGraph::parallel_worker, this, &state));
+        }
+        parallel_worker(&state);
+        for (int i = 0; i < (int)workers.size(); i++)
+        {
+            workers[i].join();
+        }
+
+        for (int a = 0; a < arcs; a++)
+        {
+            set_arc_flow(a, state.flow[a].load(memory_order_relaxed));
+        }
+        for (int u = 0; u < n; u++)
+        {
+            excess[u] = state.excess[u].load(memory_order_relaxed);
+        }
+    }
+
+    FLOW_STAT(stats.pushes += state.pushes; stats.relabels += state.relabels; stats.arcs_scanned += state.scanned);
+
+    if (convert_to_flow)
+    {
+        return_excess(source, sink);
+        store_edge_flows();
+    }
+    return excess[sink];
+}
+/**
+     * @brief Body of one parallel push-relabel thread for one epoch.
+     *
+     * Takes vertices from the shared pool in small batches, discharges them and hands surplus
+     * work back to the pool. Returns when no vertex is queued anywhere, or when the epoch is
+     * stopped for a global relabel, in which case its unfinished vertices go back to the pool.
+     *
+     * @param state The shared state of the run.
+     */
+template <class Cap>
+void BasicGraph<Cap>::parallel_worker(ParallelPushRelabelState<typename BasicGraph<Cap>::Flow> *state)
+{
+    const int batch = 64;
+    vector<int> local;
+    while (true)
+    {
+        if (state->stop.load(memory_order_relaxed))
+        {
+            lock_guard<mutex> guard(state->pool_lock);
+            state->pool.insert(state->pool.end(), local.begin(), local.end());
+            return;
+        }
+        if (local.empty())
+        {
+            {
+                lock_guard<mutex> guard(state->pool_lock);
+                int take = min((int)state->pool.size(), batch);
+                local.assign(state->pool.end() - take, state->pool.end());
+                state->pool.resize(state->pool.size() - take);
+            }
+            if (local.empty())
+            {
+                if (state->pending.load() == 0)
+                {
+                    return;
+                }
+                this_thread::yield();
+                continue;
+            }
+        }
+
+        int u = local.back();
+        local.pop_back();
+        parallel_discharge(state, u, local);
+
+        if ((int)local.size() > 2 * batch)
+        {
+            // share work with idle threads
+            lock_guard<mutex> guard(state->pool_lock);
+            state->pool.insert(state->pool.end(), local.begin() + batch, local.end());
+            local.resize(batch);
+        }
+        if (state->work.load(memory_order_relaxed) > state->work_limit)
+        {
+            state->stop.store(true, memory_order_relaxed);
+        }
+    }
+}
+/**
+     * @brief Discharges a vertex owned by the calling thread.
+     *
+     * Pushes to the lowest residual neighbour while u is above it, otherwise relabels u just
+     * above that neighbour. Neighbours that gain excess are claimed into `local`. Ownership is
+     * dropped and re-checked at the end, so excess pushed in by other threads in the meantime
+     * is never stranded.
+     *
+     * @param state The shared state of the run.
+     * @param u The owned vertex.
+     * @param local The calling thread's queue.
+     */
+template <class Cap>
+void BasicGraph<Cap>::parallel_discharge(ParallelPushRelabelState<typename BasicGraph<Cap>::Flow> *state, int u, vector<int> &local)
+{
+    long long work = 0;
+    long long pushes = 0, relabels = 0;
+    while (true)
+    {
+        while (state->excess[u].load() > 0 && state->height[u].load(memory_order_relaxed) < n)
+        {
+            int best = -1;
+            int best_height = INT_MAX;
+            for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+            {
+                if (arc_capacity(a) - state->flow[a].load(memory_order_relaxed) > 0)
+                {
+                    int h = state->height[arc_head[a]].load(memory_order_relaxed);
+                    if (h < best_height)
+                    {
+                        best_height = h;
+                        best = a;
+                    }
+                }
+            }
+            work += first_arc[u + 1] - first_arc[u];
+            if (best < 0)
+            {
+                break;
+            }
+
+            if (state->height[u].load(memory_order_relaxed) > best_height)
+            {
+                // only u lowers the residual capacity of its own arcs, so d never overshoots
+                Flow d = min(state->excess[u].load(), arc_capacity(best) - state->flow[best].load());
+                int v = arc_head[best];
+                FLOW_STAT(pushes++);
+                state->flow[best].fetch_add(d);
+                state->flow[arc_rev[best]].fetch_sub(d);
+                state->excess[u].fetch_sub(d);
+                state->excess[v].fetch_add(d);
+                if (v != state->source && v != state->sink && !state->queued[v].exchange(true))
+                {
+                    state->pending.fetch_add(1);
+                    local.push_back(v);
+                }
+            }
+            else
+            {
+                FLOW_STAT(relabels++);
+                state->height[u].store(best_height + 1 < n ? best_height + 1 : n, memory_order_relaxed);
+            }
+        }
+
+        state->queued[u].store(false);
+        if (state->excess[u].load() > 0 && state->height[u].load(memory_order_relaxed) < n && !state->queued[u].exchange(true))
+        {
+            continue;
+        }
+        break;
+    }
+    state->pending.fetch_sub(1);
+    state->work.fetch_add(work, memory_order_relaxed);
+    FLOW_STAT(state->pushes.fetch_add(pushes, memory_order_relaxed); state->relabels.fetch_add(relabels, memory_order_relaxed);
+              state->scanned.fetch_add(work, memory_order_relaxed));
+    (void)pushes;
+    (void)relabels;
+}
+/**
+     * @brief Copies the flow of every forward arc back to its edge.
+     */
+template <class Cap>
+void BasicGraph<Cap>::store_edge_flows()
+{
+    for (int i = 0; i < m; i++)
+    {
+        edges[i].flow = arc_flow_of(edge_arc[i]);
+    }
+}
+/**
+     * @brief Extracts a minimum s-t cut from the solved arcs, solving only if they hold another pair.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The cut value, both sides and the crossing edges.
+     */
+template <class Cap>
+CutResult BasicGraph<Cap>::min_cut(int source, int sink)
+{
+    if (source == sink)
+    {
+        // an empty cut, every vertex stays with the source
+        CutResult cut;
+        cut.value = 0;
+        for (int v = 0; v < n; v++)
+        {
+            cut.source_side.push_back(v);
+        }
+        return cut;
+    }
+    if (solved_source != source || solved_sink != sink)
+    {
+        max_flow(source, sink);
+    }
+    StatsTimer timer(stats.cut_us);
+
+    // after a preflow only the vertices that can still reach the sink are known to be on its side
+    bool preflow = solved_preflow;
+    if (preflow)
+    {
+        dfs_cut_reverse(sink);
+    }
+    else
+    {
+        dfs_cut(source);
+    }
+
+    CutResult cut;
+    cut.value = 0;
+    for (int v = 0; v < n; v++)
+    {
+        if (is_visited(v) != preflow)
+        {
+            cut.source_side.push_back(v);
+        }
+        else
+        {
+            cut.sink_side.push_back(v);
+        }
+    }
+    for (int i = 0; i < m; i++)
+    {
+        if (is_visited(edges[i].u) != preflow && is_visited(edges[i].v) == preflow && edges[i].capacity > 0)
+        {
+            cut.edges.push_back(i);
+            cut.value += edges[i].capacity;
+        }
+    }
+    return cut;
+}
+
+template <class Cap>
+long long BasicGraph<Cap>::decompose_flow(int source, int sink, FlowPathSink<Flow> &out)
+{
+    if (!csr_ready)
+    {
+        build_csr();
+    }
+
+    // edge m is a virtual sink -> source edge carrying the flow value, which turns the flow
+    // into a circulation: every piece is a cycle, and the ones through edge m are the paths
+    vector<Flow> left(m + 1); // flow of every edge not handed out yet
+    left[m] = 0;
+    for (int i = 0; i < m; i++)
+    {
+        left[i] = edges[i].flow > 0 ? edges[i].flow : 0;
+        if (edges[i].u == source)
+        {
+            left[m] += left[i];
+        }
+        if (edges[i].v == source)
+        {
+            left[m] -= left[i];
+        }
+    }
+    left[m] = max(left[m], (Flow)0);
+    vector<int> cursor(first_arc, first_arc + n);
+    vector<int> depth(n, -1); // position of every vertex on the walk, -1 if it is not on it
+    vector<int> walk, path, piece; // edges of the walk, vertices of the walk, edges of the piece found on it
+    long long pieces = 0;
+
+    for (int k = -1; k < n; k++)
+    {
+        int start = k < 0 ? source : k;
+        walk.clear();
+        path.assign(1, start);
+        depth[start] = 0;
+        while (!path.empty())
+        {
+            int u = path.back();
+            int e = -1, v = -1;
+            if (u == sink && left[m] > 0)
+            {
+                e = m;
+                v = source;
+            }
+            else
+            {
+                int end = first_arc[u + 1];
+                while (cursor[u] < end && (arc_edge[cursor[u]] < 0 || left[arc_edge[cursor[u]]] == 0))
+                {
+                    cursor[u]++;
+                }
+                if (cursor[u] < end)
+                {
+                    e = arc_edge[cursor[u]];
+                    v = edges[e].v;
+                }
+            }
+            if (e < 0)
+            {
+                // no flow leaves u: done at the start, otherwise the flow into u was not conserved and is dropped
+                depth[u] = -1;
+                path.pop_back();
+                if (!walk.empty())
+                {
+                    left[walk.back()] = 0;
+                    walk.pop_back();
+                }
+                continue;
+            }
+            walk.push_back(e);
+            if (depth[v] < 0)
+            {
+                depth[v] = path.size();
+                path.push_back(v);
+                continue;
+            }
+
+            // back at v: the walk from v to here is a cycle, starting it after edge m makes it a path
+            int first = depth[v];
+            Flow amount = left[walk[first]];
+            int virtual_at = -1;
+            for (int i = first; i < (int)walk.size(); i++)
+            {
+                amount = min(amount, left[walk[i]]);
+                if (walk[i] == m)
+                {
+                    virtual_at = i;
+                }
+            }
+            for (int i = first; i < (int)walk.size(); i++)
+            {
+                left[walk[i]] -= amount;
+            }
+            if (virtual_at < 0)
+            {
+                piece.assign(walk.begin() + first, walk.end());
+            }
+            else
+            {
+                piece.assign(walk.begin() + virtual_at + 1, walk.end());
+                piece.insert(piece.end(), walk.begin() + first, walk.begin() + virtual_at);
+            }
+            out.emit(piece, amount, virtual_at < 0);
+            pieces++;
+            for (size_t i = first + 1; i < path.size(); i++)
+            {
+                depth[path[i]] = -1;
+            }
+            path.resize(first + 1);
+            walk.resize(first);
+        }
+    }
+    return pieces;
+}
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::min_cost_flow(int source, int sink, long long &cost)
+{
+    // both engines start from zero flow, which also makes any pending repair moot
+    for (int i = 0; i < m; i++)
+    {
+        edges[i].flow = 0;
+    }
+    for (int i = 0; i < (int)unbalanced.size(); i++)
+    {
+        imbalance[unbalanced[i]] = 0;
+    }
+    unbalanced.clear();
+    flow_source = flow_sink = -1;
+    create_residual_graph();
+    // laid out by arc, the searches read the costs in the order they scan the arcs
+    arc_costs.resize(2 * m);
+    for (int a = 0; a < 2 * m; a++)
+    {
+        arc_costs[a] = arc_cost(a);
+    }
+
+    Flow value = cost_algorithm == COST_SCALING ? cost_scaling(source, sink) : successive_shortest_paths(source, sink);
+    solved_source = value < 0 ? -1 : source;
+    solved_sink = value < 0 ? -1 : sink;
+    solved_preflow = false;
+    if (value >= 0)
+    {
+        flow_source = source;
+        flow_sink = sink;
+    }
+    cost = flow_cost();
+    return value;
+}
+
+template <class Cap>
+bool BasicGraph<Cap>::shortest_path_potentials(vector<long long> &potential)
+{
+    potential.assign(n, 0);
+    bool negative = false;
+    for (int i = 0; i < (int)edge_cost.size(); i++)
+    {
+        negative |= edge_cost[i] < 0 && edges[i].capacity > 0;
+    }
+    if (!negative)
+    {
+        return true;
+    }
+
+    // queue-based Bellman-Ford from a virtual vertex joined to every vertex at cost 0, as in
+    // Johnson's algorithm, so it sees every cycle; a vertex queued n + 1 times lies on a negative one
+    vector<int> rounds(n, 1);
+    vector<char> queued(n, 1);
+    queue<int> q;
+    for (int v = 0; v < n; v++)
+    {
+        q.push(v);
+    }
+    while (!q.empty())
+    {
+        int u = q.front();
+        q.pop();
+        queued[u] = 0;
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+        {
+            int v = arc_head[a];
+            if (residual(a) > 0 && potential[u] + arc_costs[a] < potential[v])
+            {
+                potential[v] = potential[u] + arc_costs[a];
+                if (!queued[v])
+                {
+                    if (++rounds[v] > n)
+                    {
+                        return false;
+                    }
+                    queued[v] = 1;
+                    q.push(v);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::successive_shortest_paths(int source, int sink)
+{
+    StatsTimer timer(stats.solve_us);
+    vector<long long> potential;
+    if (!shortest_path_potentials(potential))
+    {
+        return -1;
+    }
+    const long long INF = LLONG_MAX;
+    vector<long long> dist(n);
+    vector<char> on_path(n, 0);
+    vector<int> path;
+    priority_queue<pair<long long, int>, vector<pair<long long, int>>, greater<pair<long long, int>>> heap;
+    current_arc.resize(n);
+    parent_arc.resize(n);
+    Flow total = 0;
+    while (true)
+    {
+        // Dijkstra over the reduced costs, which the potentials keep non-negative
+        FLOW_STAT(stats.searches++);
+        fill(dist.begin(), dist.end(), INF);
+        dist[source] = 0;
+        heap.push(make_pair(0LL, source));
+        while (!heap.empty())
+        {
+            long long d = heap.top().first;
+            int u = heap.top().second;
+            heap.pop();
+            if (u == sink)
+            {
+                break;
+            }
+            if (d > dist[u])
+            {
+                continue;
+            }
+            FLOW_STAT(stats.vertices_visited++; stats.arcs_scanned += first_arc[u + 1] - first_arc[u]);
+            for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+            {
+                int v = arc_head[a];
+                long long nd = d + arc_costs[a] + potential[u] - potential[v];
+                if (residual(a) > 0 && nd < dist[v])
+                {
+                    dist[v] = nd;
+                    heap.push(make_pair(nd, v));
+                }
+            }
+        }
+        if (dist[sink] == INF)
+        {
+            break;
+        }
+        // the search stops at the sink, capping the distances there keeps every reduced cost
+        // non-negative and leaves the arcs of the shortest paths at 0
+        heap = decltype(heap)();
+        for (int v = 0; v < n; v++)
+        {
+            potential[v] += min(dist[v], dist[sink]);
+            current_arc[v] = first_arc[v];
+        }
+
+        // augment along every path of zero reduced cost arcs a DFS finds, dead ends get dist INF
+        path.assign(1, source);
+        on_path[source] = 1;
+        while (!path.empty())
+        {
+            int u = path.back();
+            if (u == sink)
+            {
+                Flow d = residual(parent_arc[path[1]]);
+                for (size_t i = 2; i < path.size(); i++)
+                {
+                    d = min(d, residual(parent_arc[path[i]]));
+                }
+                for (size_t i = 1; i < path.size(); i++)
+                {
+                    push_flow(parent_arc[path[i]], d);
+                }
+                total += d;
+                FLOW_STAT(stats.record_augmentation(d));
+                // back to the tail of the first saturated arc
+                size_t keep = 1;
+                while (residual(parent_arc[path[keep]]) > 0)
+                {
+                    keep++;
+                }
+                for (size_t i = keep; i < path.size(); i++)
+                {
+                    on_path[path[i]] = 0;
+                }
+                path.resize(keep);
+                continue;
+            }
+            int end = first_arc[u + 1];
+            for (; current_arc[u] < end; current_arc[u]++)
+            {
+                int a = current_arc[u], v = arc_head[a];
+                if (residual(a) > 0 && !on_path[v] && dist[v] < INF && arc_costs[a] + potential[u] - potential[v] == 0)
+                {
+                    break;
+                }
+            }
+            if (current_arc[u] == end)
+            {
+                dist[u] = INF;
+                on_path[u] = 0;
+                path.pop_back();
+                continue;
+            }
+            int v = arc_head[current_arc[u]];
+            parent_arc[v] = current_arc[u];
+            on_path[v] = 1;
+            path.push_back(v);
+        }
+    }
+    store_edge_flows();
+    return total;
+}
+
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::cost_scaling(int source, int sink)
+{
+    Flow value = max_flow(source, sink);
+    StatsTimer timer(stats.solve_us);
+    long long max_cost = 0;
+    for (int i = 0; i < (int)edge_cost.size(); i++)
+    {
+        max_cost = max(max_cost, edge_cost[i] < 0 ? -edge_cost[i] : edge_cost[i]);
+    }
+    if (max_cost == 0)
+    {
+        return value;
+    }
+
+    // with costs scaled by n + 1, a 1-optimal circulation is optimal
+    long long scale = n + 1;
+    long long eps = max_cost * scale;
+    for (int a = 0; a < 2 * m; a++)
+    {
+        arc_costs[a] *= scale;
+    }
+    vector<long long> price(n, 0);
+    excess.assign(n, 0);
+    current_arc.resize(n);
+    while (eps > 1)
+    {
+        eps = max(1LL, eps / 8);
+        refine(eps, price);
+        FLOW_STAT(stats.phases++);
+    }
+    store_edge_flows();
+    return value;
+}
+
+template <class Cap>
+void BasicGraph<Cap>::refine(long long eps, vector<long long> &price)
+{
+    // saturating every arc of negative reduced cost makes the flow 0-optimal but unbalanced
+    queue<int> active;
+    for (int u = 0; u < n; u++)
+    {
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+        {
+            int v = arc_head[a];
+            Flow d = residual(a);
+            if (d > 0 && arc_costs[a] + price[u] - price[v] < 0)
+            {
+                push_flow(a, d);
+                excess[u] -= d;
+                excess[v] += d;
+            }
+        }
+    }
+    for (int u = 0; u < n; u++)
+    {
+        current_arc[u] = first_arc[u];
+        if (excess[u] > 0)
+        {
+            active.push(u);
+        }
+    }
+
+    // push along arcs of negative reduced cost, lower the price of a vertex that has none
+    while (!active.empty())
+    {
+        int u = active.front();
+        active.pop();
+        while (excess[u] > 0)
+        {
+            if (current_arc[u] == first_arc[u + 1])
+            {
+                long long best = LLONG_MIN;
+                for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+                {
+                    if (residual(a) > 0)
+                    {
+                        best = max(best, price[arc_head[a]] - arc_costs[a]);
+                    }
+                }
+                price[u] = best - eps;
+                current_arc[u] = first_arc[u];
+                FLOW_STAT(stats.relabels++; stats.arcs_scanned += first_arc[u + 1] - first_arc[u]);
+                continue;
+            }
+            int a = current_arc[u], v = arc_head[a];
+            Flow r = residual(a);
+            if (r > 0 && arc_costs[a] + price[u] - price[v] < 0)
+            {
+                Flow d = min(excess[u], r);
+                push_flow(a, d);
+                excess[u] -= d;
+                if (excess[v] <= 0 && excess[v] + d > 0)
+                {
+                    active.push(v);
+                }
+                excess[v] += d;
+                FLOW_STAT(stats.pushes++);
+            }
+            else
+            {
+                current_arc[u]++;
+            }
+        }
+    }
+}
+
+template <class Cap>
+long long BasicGraph<Cap>::flow_cost() const
+{
+    long long total = 0;
+    for (int i = 0; i < (int)edge_cost.size(); i++)
+    {
+        total += edge_cost[i] * (long long)edges[i].flow;
+    }
+    return total;
+}
+
+ /*
+    * @brief Lists the edges of a minimum s-t cut, reusing the flow of the last max_flow for the same pair.
+    *
+    * @param source The source vertex.
+    * @param sink The sink vertex.
+    * @return A vector of pairs representing the edges that cross the minimum cut, removed edges left out.
+    */
+template <class Cap>
+vector<pair<int, int>> BasicGraph<Cap>::st_cut(int source, int sink) {
+    CutResult cut = min_cut(source, sink);
+
+    vector<pair<int, int>> cut_edges;
+    for (int i = 0; i < (int)cut.edges.size(); i++) {
+        BasicEdge<Cap> &e = edges[cut.edges[i]];
+        cut_edges.push_back(make_pair(e.u, e.v));
+    }
+
+    return cut_edges;
+}
+
+// Helper method to perform DFS on the residual graph
+template <class Cap>
+void BasicGraph<Cap>::dfs_cut(int u) {
+    start_search();
+    search_stack.clear();
+    mark_visited(u);
+    search_stack.push_back(u);
+
+    while (!search_stack.empty()) {
+        u = search_stack.back();
+        search_stack.pop_back();
+        FLOW_STAT(stats.arcs_scanned += first_arc[u + 1] - first_arc[u]);
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++) {
+            int v = arc_head[a];
+            if (!is_visited(v) && residual(a) > 0) {
+                mark_visited(v);
+                search_stack.push_back(v);
+            }
+        }
+    }
+}
+
+// Helper method to perform DFS backwards on the residual graph
+template <class Cap>
+void BasicGraph<Cap>::dfs_cut_reverse(int u) {
+    start_search();
+    search_stack.clear();
+    mark_visited(u);
+    search_stack.push_back(u);
+
+    while (!search_stack.empty()) {
+        u = search_stack.back();
+        search_stack.pop_back();
+        FLOW_STAT(stats.arcs_scanned += first_arc[u + 1] - first_arc[u]);
+        // v reaches u through the reverse partner of an arc leaving u
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++) {
+            int v = arc_head[a];
+            if (!is_visited(v) && residual(arc_rev[a]) > 0) {
+                mark_visited(v);
+                search_stack.push_back(v);
+            }
+        }
+    }
+}
+
+/**
+     * @brief Calculates the net flow leaving the source in the current arcs.
+     *
+     * @param source The source vertex.
+     * @return The value of the flow.
+     */
+template <class Cap>
+typename BasicGraph<Cap>::Flow BasicGraph<Cap>::flow_value(int source) const
+{
+    Flow value = 0;
+    for (int a = first_arc[source]; a < first_arc[source + 1]; a++)
+    {
+        value += arc_flow_of(a);
+    }
+    return value;
+}
+/**
+     * @brief Checks that the capacities into and out of every vertex add up without overflowing Flow.
+     *
+     * @param error Receives the first edge whose capacity overflows a sum.
+     * @return true if every sum fits.
+     */
+template <class Cap>
+bool BasicGraph<Cap>::check_capacities(string &error) const
+{
+    // every partial sum over the arcs of u lies between minus its outgoing and its incoming capacity
+    vector<Flow> incoming(n, 0), outgoing(n, 0);
+    for (int i = 0; i < m; i++)
+    {
+        if (__builtin_add_overflow(outgoing[edges[i].u], (Flow)edges[i].capacity, &outgoing[edges[i].u]) ||
+            __builtin_add_overflow(incoming[edges[i].v], (Flow)edges[i].capacity, &incoming[edges[i].v]))
+        {
+            error = "the capacities of edge " + to_string(i) + " (" + to_string(edges[i].u) + ", " + to_string(edges[i].v) +
+                    ") add up beyond the range of the capacity type at one of its ends";
+            return false;
+        }
+    }
+    return true;
+}
+/**
+     * @brief Writes the graph as a binary snapshot.
+     *
+     * @param path The file to write.
+     * @param source The source vertex to record.
+     * @param sink The sink vertex to record.
+     * @param with_flow true to keep the current flow, false to store zero flow.
+     * @param error Receives the reason on failure.
+     * @return true on success.
+     */
+template <class Cap>
+bool BasicGraph<Cap>::write_snapshot(const string &path, int source, int sink, bool with_flow, string &error)
+{
+    if (!edge_cost.empty())
+    {
+        error = path + ": snapshots do not store edge costs";
+        return false;
+    }
+    if (!csr_ready)
+    {
+        build_csr();
+    }
+
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "FFGSNAP", 8);
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = 0x01020304;
+    header.capacity_bytes = sizeof(Cap);
+    header.flags = with_flow ? SNAPSHOT_HAS_FLOW : 0;
+    header.n = n;
+    header.m = m;
+    header.source = source;
+    header.sink = sink;
+
+    // lay the arrays out one after the other, each 8-byte aligned, a unit graph stores its residual bits in the flow slot
+    bool unit = CapacityTraits<Cap>::unit;
+    uint64_t arc_bytes = unit ? 0 : 2 * (uint64_t)m * sizeof(Cap);
+    uint64_t flow_bytes = unit ? (2 * (uint64_t)m + 63) / 64 * 8 : arc_bytes;
+    const void *arrays[8] = {edges, first_arc, arc_head, arc_rev, arc_edge, arc_cap, unit ? (const void *)arc_bits : arc_flow, edge_arc};
+    uint64_t sizes[8] = {m * sizeof(BasicEdge<Cap>), (n + 1) * sizeof(int), 2 * m * sizeof(int), 2 * m * sizeof(int),
+                         2 * m * sizeof(int), arc_bytes, flow_bytes, m * sizeof(int)};
+    uint64_t *offsets[8] = {&header.edges, &header.first_arc, &header.arc_head, &header.arc_rev,
+                            &header.arc_edge, &header.arc_cap, &header.arc_flow, &header.edge_arc};
+    uint64_t offset = (sizeof(header) + 7) & ~7ULL;
+    for (int i = 0; i < 8; i++)
+    {
+        *offsets[i] = offset;
+        offset = (offset + sizes[i] + 7) & ~7ULL;
+    }
+
+    ofstream out(path.c_str(), ios::binary | ios::trunc);
+    if (!out)
+    {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    uint64_t written = sizeof(header);
+    const char zeros[8] = {0};
+    vector<uint64_t> zero_flow;
+    vector<BasicEdge<Cap>> zero_edges;
+    if (!with_flow)
+    {
+        // zero flow leaves the residual of every forward arc at its capacity, and zero bytes otherwise
+        zero_flow.assign((flow_bytes + 7) / 8, 0);
+        zero_edges.assign(edges, edges + m);
+        for (int i = 0; i < m; i++)
+        {
+            zero_edges[i].flow = 0;
+            if (unit && edges[i].capacity)
+            {
+                zero_flow[edge_arc[i] >> 6] |= 1ULL << (edge_arc[i] & 63);
+            }
+        }
+        arrays[0] = zero_edges.data();
+        arrays[6] = zero_flow.data();
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        out.write(zeros, *offsets[i] - written);
+        out.write(static_cast<const char *>(arrays[i]), sizes[i]);
+        written = *offsets[i] + sizes[i];
+    }
+    out.write(zeros, offset - written);
+    if (!out)
+    {
+        error = path + ": write failed";
+        return false;
+    }
+    return true;
+}
+
+// function to check the arrays of a mapped snapshot in one pass, so that no engine can index outside them
+template <class Cap>
+static const char *check_snapshot_arrays(int n, int m, const BasicEdge<Cap> *edges, const int *first_arc, const int *arc_head,
+                                         const int *arc_rev, const int *arc_edge, const int *edge_arc, const Cap *arc_cap,
+                                         const Cap *arc_flow, const uint64_t *arc_bits)
+{
+    if (first_arc[0] != 0 || first_arc[n] != 2 * m)
+    {
+        return "snapshot arc offsets are inconsistent";
+    }
+    for (int i = 0; i < m; i++)
+    {
+        if (edges[i].u < 0 || edges[i].u >= n || edges[i].v < 0 || edges[i].v >= n || edges[i].capacity < Cap())
+        {
+            return "snapshot edge is out of range";
+        }
+    }
+    for (int u = 0; u < n; u++)
+    {
+        if (first_arc[u + 1] < first_arc[u] || first_arc[u + 1] > 2 * m)
+        {
+            return "snapshot arc offsets are inconsistent";
+        }
+        for (int a = first_arc[u]; a < first_arc[u + 1]; a++)
+        {
+            int rev = arc_rev[a], i = arc_edge[a] < 0 ? ~arc_edge[a] : arc_edge[a];
+            if (arc_head[a] < 0 || arc_head[a] >= n || rev < 0 || rev >= 2 * m || arc_rev[rev] != a || i >= m)
+            {
+                return "snapshot arcs are inconsistent";
+            }
+            // the forward arc of edge i runs u -> v and is the one edge_arc names, its reverse arc runs v -> u
+            bool forward = arc_edge[a] >= 0;
+            if (forward ? edge_arc[i] != a || arc_edge[rev] != ~i || edges[i].u != u || edges[i].v != arc_head[a]
+                        : arc_edge[rev] != i || edges[i].v != u || edges[i].u != arc_head[a])
+            {
+                return "snapshot arcs are inconsistent";
+            }
+            if (!forward)
+            {
+                continue;
+            }
+            // a stored flow has to be a feasible flow on the arc, or the engines would run past its capacity
+            if (CapacityTraits<Cap>::unit)
+            {
+                int residual = (arc_bits[a >> 6] >> (a & 63)) & 1, back = (arc_bits[rev >> 6] >> (rev & 63)) & 1;
+                if (residual + back != edges[i].capacity)
+                {
+                    return "snapshot flow is inconsistent";
+                }
+            }
+            else if (arc_cap[a] != edges[i].capacity || arc_cap[rev] != Cap() || arc_flow[a] < Cap() || arc_flow[a] > arc_cap[a] ||
+                     arc_flow[rev] != -arc_flow[a])
+            {
+                return "snapshot flow is inconsistent";
+            }
+        }
+    }
+    return nullptr;
+}
+
+/**
+     * @brief Replaces the graph by a memory-mapped snapshot.
+     *
+     * @param path The snapshot to map.
+     * @param source Receives the recorded source vertex.
+     * @param sink Receives the recorded sink vertex.
+     * @param error Receives the reason on failure.
+     * @return true on success.
+     */
+template <class Cap>
+bool BasicGraph<Cap>::map_snapshot(const string &path, int &source, int &sink, string &error)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(SnapshotHeader))
+    {
+        error = path + ": not a graph snapshot";
+        close(fd);
+        return false;
+    }
+    void *p = mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+
+    const SnapshotHeader *header = static_cast<const SnapshotHeader *>(p);
+    uint64_t vertices = header->n, arcs = 2 * (uint64_t)header->m;
+    const char *problem = nullptr;
+    if (memcmp(header->magic, "FFGSNAP", 8) != 0)
+    {
+        problem = "not a graph snapshot";
+    }
+    else if (header->byte_order != 0x01020304)
+    {
+        problem = "snapshot was written with a different byte order";
+    }
+    else if (header->version != SNAPSHOT_VERSION)
+    {
+        problem = "unsupported snapshot version";
+    }
+    else if (header->capacity_bytes != sizeof(Cap))
+    {
+        problem = "snapshot capacity type does not match";
+    }
+    else if (header->n <= 0 || header->m < 0 || header->m > INT_MAX / 2 || header->source < 0 || header->source >= header->n || header->sink < 0 || header->sink >= header->n)
+    {
+        problem = "corrupt snapshot header";
+    }
+    else if (header->source == header->sink)
+    {
+        problem = "the source and the sink must be different vertices";
+    }
+    else
+    {
+        uint64_t offsets[8] = {header->edges, header->first_arc, header->arc_head, header->arc_rev,
+                               header->arc_edge, header->arc_cap, header->arc_flow, header->edge_arc};
+        bool unit = CapacityTraits<Cap>::unit;
+        uint64_t arc_bytes = unit ? 0 : arcs * sizeof(Cap);
+        uint64_t flow_bytes = unit ? (arcs + 63) / 64 * 8 : arc_bytes;
+        uint64_t sizes[8] = {arcs / 2 * sizeof(BasicEdge<Cap>), (vertices + 1) * sizeof(int), arcs * sizeof(int), arcs * sizeof(int),
+                             arcs * sizeof(int), arc_bytes, flow_bytes, arcs / 2 * sizeof(int)};
+        for (int i = 0; i < 8; i++)
+        {
+            if (offsets[i] % 8 != 0 || offsets[i] > (uint64_t)st.st_size || sizes[i] > (uint64_t)st.st_size - offsets[i])
+            {
+                problem = "snapshot is truncated";
+            }
+        }
+        if (!problem)
+        {
+            const char *base = static_cast<const char *>(p);
+            problem = check_snapshot_arrays<Cap>(header->n, header->m, reinterpret_cast<const BasicEdge<Cap> *>(base + header->edges),
+                                                 reinterpret_cast<const int *>(base + header->first_arc),
+                                                 reinterpret_cast<const int *>(base + header->arc_head),
+                                                 reinterpret_cast<const int *>(base + header->arc_rev),
+                                                 reinterpret_cast<const int *>(base + header->arc_edge),
+                                                 reinterpret_cast<const int *>(base + header->edge_arc),
+                                                 reinterpret_cast<const Cap *>(base + header->arc_cap),
+                                                 reinterpret_cast<const Cap *>(base + header->arc_flow),
+                                                 reinterpret_cast<const uint64_t *>(base + header->arc_flow));
+        }
+    }
+    if (problem)
+    {
+        error = path + ": " + problem;
+        munmap(p, st.st_size);
+        return false;
+    }
+
+    reset(header->n);
+    char *base = static_cast<char *>(p);
+    mapping = p;
+    mapping_size = st.st_size;
+    m = header->m;
+    edges = reinterpret_cast<BasicEdge<Cap> *>(base + header->edges);
+    edge_room = m;
+    first_arc = reinterpret_cast<int *>(base + header->first_arc);
+    arc_head = reinterpret_cast<int *>(base + header->arc_head);
+    arc_rev = reinterpret_cast<int *>(base + header->arc_rev);
+    arc_edge = reinterpret_cast<int *>(base + header->arc_edge);
+    if (CapacityTraits<Cap>::unit)
+    {
+        arc_bits = reinterpret_cast<uint64_t *>(base + header->arc_flow);
+    }
+    else
+    {
+        arc_cap = reinterpret_cast<Cap *>(base + header->arc_cap);
+        arc_flow = reinterpret_cast<Cap *>(base + header->arc_flow);
+    }
+    edge_arc = reinterpret_cast<int *>(base + header->edge_arc);
+    arc_room = 2 * m;
+    csr_ready = true;
+    source = header->source;
+    sink = header->sink;
+    if (header->flags & SNAPSHOT_HAS_FLOW)
+    {
+        flow_source = source;
+        flow_sink = sink;
+    }
+    return true;
+}
+
+/**
+ * @brief Read-only memory mapping of a whole file, unmapped when it goes out of scope.
+ */
+class MappedFile
+{
+public:
+    const char *data; // first byte of the file
+    size_t size;      // length of the file in bytes
+
+    MappedFile();
+    ~MappedFile();
+
+    /**
+     * @brief Maps the file at path.
+     *
+     * @param path The file to map.
+     * @param error Receives the reason on failure.
+     * @return true on success.
+     */
+    bool open(const string &path, string &error);
+
+private:
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+};
+
+MappedFile::MappedFile()
+{
+    data = nullptr;
+    size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+    if (data)
+    {
+        munmap(const_cast<char *>(data), size);
+    }
+}
+
+bool MappedFile::open(const string &path, string &error)
+{
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+    {
+        error = path + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+    size = st.st_size;
+    if (size == 0)
+    {
+        // mmap rejects empty mappings, an empty file simply has no bytes
+        close(fd);
+        return true;
+    }
+    void *p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+    {
+        error = path + ": " + strerror(errno);
+        size = 0;
+        return false;
+    }
+    madvise(p, size, MADV_SEQUENTIAL);
+    data = static_cast<const char *>(p);
+    return true;
+}
+
+/**
+ * @brief Cursor over the text of an edge list that keeps track of the line number.
+ */
+struct TextScanner
+{
+    const char *p;   // next unread byte
+    const char *end; // one past the last byte
+    int line;        // 1-based line of p
+
+    // skips blanks (any control character or space), and line breaks as well when cross_lines is set
+    void skip(bool cross_lines)
+    {
+        while (p < end && (unsigned char)*p <= ' ')
+        {
+            if (*p == '\n')
+            {
+                if (!cross_lines)
+                {
+                    return;
+                }
+                line++;
+            }
+            p++;
+        }
+    }
+
+    bool at_line_end() const { return p == end || *p == '\n'; }
+    bool at_blank() const { return p == end || (unsigned char)*p <= ' '; }
+
+    /**
+     * @brief Parses a decimal integer that fits in an int.
+     *
+     * @param value Receives the integer.
+     * @param error Receives the reason on failure.
+     * @return true on success.
+     */
+    bool read_int(int &value, string &error)
+    {
+        const char *start = p;
+        long long x;
+        if (!read_long(x, error))
+        {
+            return false;
+        }
+        if (x > INT_MAX || x < -(long long)INT_MAX)
+        {
+            error = "integer '" + string(start, p) + "' does not fit in an int";
+            return false;
+        }
+        value = (int)x;
+        return true;
+    }
+
+    /**
+     * @brief Parses a decimal integer that fits in a long long.
+     *
+     * @param value Receives the integer.
+     * @param error Receives the reason on failure.
+     * @return true on success.
+     */
+    bool read_long(long long &value, string &error)
+    {
+        const char *start = p;
+        bool negative = false;
+        if (p < end && (*p == '-' || *p == '+'))
+        {
+            negative = *p == '-';
+            p++;
+        }
+        // the magnitude may reach LLONG_MAX, one more for a negative value
+        unsigned long long limit = (unsigned long long)LLONG_MAX + negative, x = 0;
+        bool overflow = false;
+        const char *digits = p;
+        while (p < end && (unsigned)(*p - '0') < 10u)
+        {
+            unsigned digit = *p - '0';
+            overflow |= x > (limit - digit) / 10;
+            x = x * 10 + digit;
+            p++;
+        }
+        if (p == digits || !at_blank())
+        {
+            while (!at_blank())
+            {
+                p++;
+            }
+            error = "expected an integer, found '" + string(start, p) + "'";
+            return false;
+        }
+        if (overflow)
+        {
+            error = "integer '" + string(start, p) + "' does not fit in 64 bits";
+            return false;
+        }
+        value = negative ? (long long)(0 - x) : (long long)x;
+        return true;
+    }
+};
+
+/**
+ * @brief Loads a graph in the inputTask1.txt format: n, then source and sink, then one `u v capacity` edge per line.
+ *
+ * The file is memory-mapped. A first pass counts the lines so the edges and the arcs are
+ * allocated exactly once, a second pass parses the integers by hand. Parsing stops at the
+ * first malformed line instead of silently dropping the rest of the file. An optional
+ * fourth column gives the cost per unit of flow of the edge for min_cost_flow.
+ *
+ * @param path The file to read.
+ * @param G Receives the graph, reset to the vertex count of the file.
+ * @param source Receives the source vertex.
+ * @param sink Receives the sink vertex.
+ * @param error Receives "path:line: message" on failure.
+ * @return true on success.
+ */
+template <class Cap>
+bool load_edge_list(const string &path, BasicGraph<Cap> &G, int &source, int &sink, string &error)
+{
+    MappedFile file;
+    if (!file.open(path, error))
+    {
+        return false;
+    }
+    TextScanner in = {file.data, file.data + file.size, 1};
+    string what;
+
+    int n;
+    in.skip(true);
+    if (in.p == in.end)
+    {
+        error = path + ": empty file, expected the number of vertices";
+        return false;
+    }
+    if (!in.read_int(n, what) || n <= 0)
+    {
+        error = path + ":" + to_string(in.line) + ": " + (what.empty() ? "the number of vertices must be positive" : what);
+        return false;
+    }
+    int *ends[2] = {&source, &sink};
+    for (int i = 0; i < 2; i++)
+    {
+        in.skip(true);
+        if (in.p == in.end)
+        {
+            error = path + ":" + to_string(in.line) + ": expected the source and the sink";
+            return false;
+        }
+        if (!in.read_int(*ends[i], what) || *ends[i] < 0 || *ends[i] >= n)
+        {
+            error = path + ":" + to_string(in.line) + ": " + (what.empty() ? "vertex " + to_string(*ends[i]) + " is out of range" : what);
+            return false;
+        }
+    }
+    if (source == sink)
+    {
+        error = path + ":" + to_string(in.line) + ": the source and the sink must be different vertices";
+        return false;
+    }
+
+    // every remaining line holds at most one edge
+    int lines = 1;
+    for (const char *q = in.p; (q = static_cast<const char *>(memchr(q, '\n', in.end - q))) != nullptr; q++)
+    {
+        lines++;
+    }
+    G.reset(n);
+    G.reserve_edges(lines);
+
+    while (true)
+    {
+        in.skip(true);
+        if (in.p == in.end)
+        {
+            break;
+        }
+        long long edge[3];
+        for (int i = 0; i < 3; i++)
+        {
+            if (i > 0)
+            {
+                in.skip(false);
+                if (in.at_line_end())
+                {
+                    error = path + ":" + to_string(in.line) + ": expected 'u v capacity'";
+                    return false;
+                }
+            }
+            if (!in.read_long(edge[i], what))
+            {
+                error = path + ":" + to_string(in.line) + ": " + what;
+                return false;
+            }
+        }
+        long long cost = 0;
+        in.skip(false);
+        if (!in.at_line_end())
+        {
+            if (!in.read_long(cost, what))
+            {
+                error = path + ":" + to_string(in.line) + ": " + what;
+                return false;
+            }
+            in.skip(false);
+        }
+        if (!in.at_line_end())
+        {
+            error = path + ":" + to_string(in.line) + ": trailing data after 'u v capacity cost'";
+            return false;
+        }
+        if (cost < INT_MIN || cost > INT_MAX)
+        {
+            error = path + ":" + to_string(in.line) + ": cost " + to_string(cost) + " does not fit in an int";
+            return false;
+        }
+        if (edge[0] < 0 || edge[0] >= n || edge[1] < 0 || edge[1] >= n)
+        {
+            error = path + ":" + to_string(in.line) + ": vertex out of range [0, " + to_string(n) + ")";
+            return false;
+        }
+        if (edge[2] < 0)
+        {
+            error = path + ":" + to_string(in.line) + ": negative capacity";
+            return false;
+        }
+        if (edge[2] > (long long)numeric_limits<Cap>::max())
+        {
+            error = path + ":" + to_string(in.line) + ": capacity " + to_string(edge[2]) + " is above the largest capacity " +
+                    to_string((long long)numeric_limits<Cap>::max()) + " of this graph type";
+            return false;
+        }
+        G.add_edge(edge[0], edge[1], (Cap)edge[2], cost);
+    }
+    G.build_csr();
+    return true;
+}
+
+/**
+ * @brief Loads a graph from a binary edge list.
+ *
+ * @param path The file to read.
+ * @param G Receives the graph, reset to the vertex count of the file.
+ * @param source Receives the source vertex.
+ * @param sink Receives the sink vertex.
+ * @param error Receives the reason on failure.
+ * @return true on success.
+ */
+template <class Cap>
+bool load_binary_edges(const string &path, BasicGraph<Cap> &G, int &source, int &sink, string &error)
+{
+    MappedFile file;
+    if (!file.open(path, error))
+    {
+        return false;
+    }
+    if (file.size < sizeof(EdgeListHeader))
+    {
+        error = path + ": not a binary edge list";
+        return false;
+    }
+    EdgeListHeader header;
+    memcpy(&header, file.data, sizeof(header));
+    if (memcmp(header.magic, "FFGEDGE", 8) != 0)
+    {
+        error = path + ": not a binary edge list";
+        return false;
+    }
+    if (header.byte_order != 0x01020304)
+    {
+        error = path + ": edge list was written with a different byte order";
+        return false;
+    }
+    if (header.version != EDGE_LIST_VERSION)
+    {
+        error = path + ": unsupported edge list version";
+        return false;
+    }
+    int n = header.n;
+    if (n <= 0 || header.source < 0 || header.source >= n || header.sink < 0 || header.sink >= n || header.m < 0 || header.m > INT_MAX)
+    {
+        error = path + ": corrupt edge list header";
+        return false;
+    }
+    if (header.source == header.sink)
+    {
+        error = path + ": the source and the sink must be different vertices";
+        return false;
+    }
+    if ((uint64_t)header.m > (file.size - sizeof(header)) / (3 * sizeof(int32_t)))
+    {
+        error = path + ": edge list is truncated";
+        return false;
+    }
+
+    source = header.source;
+    sink = header.sink;
+    G.reset(n);
+    G.reserve_edges(header.m);
+    const char *p = file.data + sizeof(header);
+    for (int64_t i = 0; i < header.m; i++, p += 3 * sizeof(int32_t))
+    {
+        int32_t edge[3];
+        memcpy(edge, p, sizeof(edge));
+        if ((uint32_t)edge[0] >= (uint32_t)n || (uint32_t)edge[1] >= (uint32_t)n || edge[2] < 0 ||
+            edge[2] > (long long)numeric_limits<Cap>::max())
+        {
+            error = path + ": edge " + to_string(i) + " is out of range";
+            return false;
+        }
+        G.add_edge(edge[0], edge[1], (Cap)edge[2]);
+    }
+    G.build_csr();
+    return true;
+}
+
+// dispatches on the magic bytes of the file
+template <class Cap>
+static bool load_graph_file(const string &path, BasicGraph<Cap> &G, int &source, int &sink, string &error)
+{
+    char magic[8] = {0};
+    ifstream probe(path.c_str(), ios::binary);
+    probe.read(magic, sizeof(magic));
+    if (probe.gcount() == sizeof(magic) && memcmp(magic, "FFGSNAP", 8) == 0)
+    {
+        return G.map_snapshot(path, source, sink, error);
+    }
+    if (probe.gcount() == sizeof(magic) && memcmp(magic, "FFGEDGE", 8) == 0)
+    {
+        return load_binary_edges(path, G, source, sink, error);
+    }
+    return load_edge_list(path, G, source, sink, error);
+}
+
+template <class Cap>
+bool load_graph(const string &path, BasicGraph<Cap> &G, int &source, int &sink, string &error)
+{
+    double load_us = 0;
+    bool loaded;
+    {
+        StatsTimer timer(load_us);
+        loaded = load_graph_file(path, G, source, sink, error);
+    }
+    if (loaded && !G.check_capacities(error))
+    {
+        error = path + ": " + error;
+        loaded = false;
+    }
+    // loading resets the graph, and with it the stats, so the time is recorded afterwards
+    G.stats.load_us = load_us;
+    return loaded;
+}
+
+template class BasicGraph<int>;
+template class BasicGraph<long long>;
+template class BasicGraph<bool>;
+template bool load_edge_list(const string &, Graph &, int &, int &, string &);
+template bool load_edge_list(const string &, Graph64 &, int &, int &, string &);
+template bool load_edge_list(const string &, UnitGraph &, int &, int &, string &);
+template bool load_binary_edges(const string &, Graph &, int &, int &, string &);
+template bool load_binary_edges(const string &, Graph64 &, int &, int &, string &);
+template bool load_binary_edges(const string &, UnitGraph &, int &, int &, string &);
+template bool load_graph(const string &, Graph &, int &, int &, string &);
+template bool load_graph(const string &, Graph64 &, int &, int &, string &);
+template bool load_graph(const string &, UnitGraph &, int &, int &, string &);
@@ -0,0 +1,809 @@
+#ifndef MAXFLOW_H
+#define MAXFLOW_H
+
+#include <vector>
+#include <algorithm>
+#include <climits>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <cstddef>
+#include <string>
+#include <cstdint>
+#include <limits>
+using namespace std;
+
+/**
+ * @brief The max-flow engines that Graph::max_flow can run.
+ */
+enum FlowAlgorithm
+{
+    FORD_FULKERSON, // augmenting paths found by DFS in vertex order
+    EDMONDS_KARP,   // shortest augmenting paths found by BFS
+    DINIC,          // BFS level graph and blocking flows with current-arc pointers
+    PUSH_RELABEL,   // highest-label push-relabel with global relabeling and the gap heuristic
+    PARALLEL_PUSH_RELABEL // lock-free multi-threaded push-relabel
+};
+
+/**
+ * @brief The min-cost flow engines that Graph::min_cost_flow can run.
+ */
+enum CostAlgorithm
+{
+    SUCCESSIVE_SHORTEST_PATHS, // Dijkstra on reduced costs with Johnson potentials, one blocking flow per search
+    COST_SCALING               // max flow first, then eps-scaling push-relabel on the min cost circulation
+};
+
+/**
+ * @brief Properties of a capacity type of BasicGraph.
+ *
+ * `Flow` holds sums of capacities: excesses, path flows and flow values. The bool
+ * instantiation is the unit-capacity network, where every capacity is 0 or 1 and the
+ * residual graph keeps a single bit per arc.
+ */
+template <class Cap>
+struct CapacityTraits
+{
+    typedef Cap Flow;
+    static const bool unit = false;
+};
+
+template <>
+struct CapacityTraits<bool>
+{
+    typedef int Flow;
+    static const bool unit = true;
+};
+
+/**
+ * @brief Shared state of the threads running the parallel push-relabel engine.
+ *
+ * Flows, labels and excesses are atomic copies of the Graph arrays. A vertex is owned by at
+ * most one thread at a time: whoever flips its `queued` flag from false to true discharges it.
+ */
+template <class Flow>
+struct ParallelPushRelabelState
+{
+    unique_ptr<atomic<Flow>[]> flow;   // flow on every arc
+    unique_ptr<atomic<int>[]> height;  // label of every vertex
+    unique_ptr<atomic<Flow>[]> excess; // excess of every vertex
+    unique_ptr<atomic<bool>[]> queued; // true while a thread owns the vertex
+    mutex pool_lock;
+    vector<int> pool;          // queued vertices not held by any thread
+    atomic<long long> pending; // queued vertices, held or pooled
+    atomic<long long> work;    // arcs scanned by relabels in this epoch
+    atomic<long long> pushes, relabels, scanned; // FLOW_STATS totals of the run
+    atomic<bool> stop;         // set when the epoch should end for a global relabel
+    long long work_limit;
+    int source, sink;
+};
+template <class Cap>
+struct BasicEdge
+{
+    int u, v;     // Source and destination nodes
+    Cap capacity; // Capacity of the edge
+    Cap flow;     // Current flow on the edge
+    // Edge* residual;        // Pointer to the residual edge in the residual graph
+
+    // Constructor to initialize the edge
+    /**
+     * @brief Constructor for creating a new BasicEdge instance.
+     *
+     * @param u The source vertex of the edge.
+     * @param v The destination vertex of the edge.
+     * @param capacity The capacity of the edge.
+     */
+    BasicEdge(int u, int v, Cap capacity) : u(u), v(v), capacity(capacity), flow(0) {}
+};
+
+typedef BasicEdge<int> Edge;
+
+/**
+ * @brief Bump allocator backing all storage of one Graph.
+ *
+ * Memory is carved out of large blocks and never freed piecemeal: reset() rewinds to the
+ * first block and keeps the others for reuse, release() returns everything to the system.
+ */
+class Arena
+{
+public:
+    Arena();
+    ~Arena();
+
+    /**
+     * @brief Returns uninitialised storage for count objects of type T.
+     *
+     * @param count The number of objects.
+     * @return A pointer aligned for T, valid until the next reset() or release().
+     */
+    template <typename T>
+    T *allocate(size_t count)
+    {
+        return static_cast<T *>(allocate_bytes(count * sizeof(T), alignof(T)));
+    }
+
+    // method to carve bytes out of the current block
+    void *allocate_bytes(size_t bytes, size_t align);
+
+    // method to make all blocks available again without freeing them
+    void reset();
+
+    // method to free all blocks
+    void release();
+
+private:
+    vector<pair<char *, size_t>> blocks; // start and size of every block
+    size_t block;                        // block currently carved from
+    size_t used;                         // bytes used in that block
+
+    Arena(const Arena &);
+    Arena &operator=(const Arena &);
+};
+
+/**
+ * @brief Counters and timers of the solver, kept in Graph::stats.
+ *
+ * They are only filled in when the solver is compiled with -DFLOW_STATS. Otherwise every
+ * FLOW_STAT hook expands to nothing, so the hot loops carry no cost and all counters stay 0.
+ */
+struct FlowStats
+{
+    long long augmentations;     // augmenting paths pushed by ff, ek and dinic
+    long long bottleneck[64];    // augmentations by floor(log2(bottleneck))
+    long long searches;          // path searches, level graphs and cut searches
+    long long vertices_visited;  // vertices reached by those searches
+    long long max_visited;       // most vertices reached by a single search
+    long long search_visited;    // vertices reached by the current search
+    long long arcs_scanned;      // arcs looked at by searches, blocking flows, pushes and relabels
+    long long residual_rebuilds; // arc layouts built from the edge list
+    long long residual_syncs;    // arc flows refreshed from the edges
+    long long phases;            // Dinic phases, scaling phases or parallel epochs
+    long long pushes;
+    long long relabels;
+    long long global_relabels;
+    long long gaps;              // gap heuristic firings
+    long long repair_paths;      // paths that moved flow off edges whose capacity dropped below it
+    double load_us;              // time in load_graph
+    double solve_us;             // time in max_flow and min_cut_value, summed over calls
+    double cut_us;               // time in st_cut, summed over calls
+
+    FlowStats() { reset(); }
+
+    // method to zero every counter and timer
+    void reset();
+
+    // method to count one augmentation with the given bottleneck
+    void record_augmentation(long long bottleneck);
+
+    // method to write the counters as a JSON object
+    string to_json() const;
+};
+
+#ifdef FLOW_STATS
+#define FLOW_STAT(statement) \
+    do                       \
+    {                        \
+        statement;           \
+    } while (0)
+#else
+#define FLOW_STAT(statement) \
+    do                       \
+    {                        \
+    } while (0)
+#endif
+
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint32_t SNAPSHOT_HAS_FLOW = 1; // the flow arrays hold a solved flow rather than zeros
+
+/**
+ * @brief Header of a binary graph snapshot.
+ *
+ * The header is followed by the Graph arrays exactly as they sit in memory. Offsets are in
+ * bytes from the start of the file and 8-byte aligned, so a mapped snapshot is used in place.
+ */
+struct SnapshotHeader
+{
+    char magic[8];           // "FFGSNAP" and a zero byte
+    uint32_t version;        // SNAPSHOT_VERSION
+    uint32_t byte_order;     // 0x01020304 as stored by the machine that wrote the file
+    uint32_t capacity_bytes; // size of a capacity value
+    uint32_t flags;          // SNAPSHOT_HAS_FLOW
+    int32_t n, m, source, sink;
+    uint64_t edges, first_arc, arc_head, arc_rev, arc_edge, arc_cap, arc_flow, edge_arc; // array offsets
+};
+
+const uint32_t EDGE_LIST_VERSION = 1;
+
+/**
+ * @brief Header of a binary edge list, followed by m (u, v, capacity) records of int32_t.
+ *
+ * Unlike a snapshot it needs no arc layout, so a generator can stream it edge by edge and
+ * fill in m once it is done.
+ */
+struct EdgeListHeader
+{
+    char magic[8];       // "FFGEDGE" and a zero byte
+    uint32_t version;    // EDGE_LIST_VERSION
+    uint32_t byte_order; // 0x01020304 as stored by the machine that wrote the file
+    int32_t n, source, sink, reserved;
+    int64_t m;
+};
+
+/**
+ * @brief A minimum s-t cut read off a solved graph.
+ */
+struct CutResult
+{
+    long long value;           // capacity of the cut, equal to the max flow
+    vector<int> source_side;   // vertices on the source side, in increasing order
+    vector<int> sink_side;     // vertices on the sink side, in increasing order
+    vector<int> edges;         // indices of the edges from the source side to the sink side, removed edges left out
+};
+
+/**
+ * @brief Receives the paths and cycles of a flow decomposition one at a time.
+ *
+ * Nothing of a piece is kept once emit returns, so a decomposition holds at most one path
+ * in memory however many it produces.
+ */
+template <class Flow>
+struct FlowPathSink
+{
+    virtual ~FlowPathSink() {}
+
+    // method to take one piece: the edge indices along it, the flow it carries, and whether it is a cycle
+    virtual void emit(const vector<int> &path, Flow amount, bool cycle) = 0;
+};
+
+/**
+ * @brief Flow network with capacities of type Cap and the max-flow engines that run on it.
+ *
+ * Instantiated for int (Graph), for 64-bit capacities (Graph64) and for unit capacities
+ * (UnitGraph, Cap = bool). The unit network keeps one residual bit per arc in arc_bits
+ * instead of the two int arrays arc_cap and arc_flow. None of the instantiations checks
+ * arithmetic in the hot loops, check_capacities bounds every sum once instead.
+ */
+template <class Cap>
+class BasicGraph
+{
+public:
+    typedef typename CapacityTraits<Cap>::Flow Flow;
+
+    int n;       // number of vertices in the graph
+    int m;       // number of edges in the graph
+    BasicEdge<Cap> *edges; // edges of the graph in the order they were added
+    int edge_room; // edges that fit before `edges` has to move
+
+    // Compressed sparse residual graph. Every edge owns a forward arc and a reverse arc,
+    // the arcs leaving u are first_arc[u] .. first_arc[u + 1] - 1.
+    int *first_arc; // offset of the first arc of every vertex, n + 1 entries
+    int *arc_head;  // head vertex of every arc
+    int *arc_rev;   // index of the paired reverse arc
+    int *arc_edge;  // index of the owning edge, ~index for reverse arcs
+    Cap *arc_cap;   // capacity of every arc, 0 for reverse arcs
+    Cap *arc_flow;  // flow on every arc, arc_flow[arc_rev[a]] == -arc_flow[a]
+    uint64_t *arc_bits; // UnitGraph only, in place of arc_cap and arc_flow: the residual capacity of arc a is bit a
+    int *edge_arc;  // forward arc of every edge
+    int arc_room;   // arcs that fit in the arc arrays
+    bool csr_ready; // false while edges were added after the arcs were laid out
+    Arena arena;    // owns the edges and the arc arrays
+    void *mapping;  // snapshot the arrays point into instead, nullptr if none
+    size_t mapping_size;
+    FlowAlgorithm algorithm; // engine used by max_flow, FORD_FULKERSON by default
+    vector<long long> edge_cost;  // cost per unit of flow of every edge, empty while every cost is 0
+    CostAlgorithm cost_algorithm; // engine used by min_cost_flow, SUCCESSIVE_SHORTEST_PATHS by default
+    vector<long long> arc_costs;  // arc_cost of every arc while min_cost_flow runs, multiplied by n + 1 for cost scaling
+
+    // push-relabel state, one entry per vertex
+    vector<int> height;      // distance label
+    vector<Flow> excess;     // inflow minus outflow
+    vector<int> current_arc; // next arc to try when discharging
+    vector<int> active_head, active_next;           // active vertices bucketed by height
+    vector<int> label_head, label_next, label_prev; // all vertices below n bucketed by height, for the gap heuristic
+    int highest_active, highest_label;
+    long long relabel_work; // arcs scanned by relabels since the last global relabel
+    int threads;            // worker threads of PARALLEL_PUSH_RELABEL
+    bool capacity_scaling;  // FORD_FULKERSON and EDMONDS_KARP only augment along arcs with residual >= delta
+    FlowStats stats;        // filled in when compiled with FLOW_STATS
+    int solved_source, solved_sink; // pair whose maximum flow or preflow the arcs hold, -1 if none
+    int flow_source, flow_sink;     // pair the flow in Edge::flow was solved for, -1 while every edge flow is 0
+    bool solved_preflow;            // the arcs hold a maximum preflow from min_cut_value, not a flow
+
+    // augmenting path search scratch, reused by every search
+    vector<unsigned> visit_mark; // a vertex is visited when its mark equals visit_epoch
+    unsigned visit_epoch;
+    vector<int> parent_arc;    // arc through which each visited vertex was reached
+    vector<int> search_cursor; // next arc to try for each vertex on the DFS stack
+    vector<int> search_stack;  // DFS stack, or BFS queue
+
+    // flow left unbalanced by capacity decreases, repaired by the next solve
+    vector<Flow> imbalance; // inflow minus outflow of every vertex the decreases touched
+    vector<int> unbalanced; // vertices whose imbalance may be nonzero
+
+    // constructor to initialize the graph
+    /**
+     * @brief Construct a new Graph object with the given number of vertices.
+     *
+     * @param n The number of vertices in the graph.
+     */
+    BasicGraph(int n);
+
+    /**
+     * @brief Empties the graph for reuse with n vertices.
+     *
+     * All edge and arc storage goes back to the arena in one step, so solving many graphs
+     * in a row allocates only when a graph is larger than every graph before it.
+     *
+     * @param n The number of vertices of the next graph.
+     */
+    void reset(int n);
+
+    // method to reserve room for m edges so add_edge never has to move them
+    void reserve_edges(int m);
+
+    /**
+     * @brief Writes the graph, with its arcs laid out, as a binary snapshot.
+     *
+     * @param path The file to write.
+     * @param source The source vertex to record.
+     * @param sink The sink vertex to record.
+     * @param with_flow true to keep the current flow, false to store zero flow.
+     * @param error Receives the reason on failure.
+     * @return true on success.
+     */
+    bool write_snapshot(const string &path, int source, int sink, bool with_flow, string &error);
+
+    /**
+     * @brief Replaces the graph by a memory-mapped snapshot without touching its edges.
+     *
+     * The mapping is private and writable: pages stay shared with the page cache and other
+     * processes until a solve writes flow into them.
+     *
+     * A snapshot is not trusted: before the graph uses it, one O(n + m) pass checks that the
+     * arc offsets are monotone, every head, reverse arc and edge index is in range and agrees
+     * with the edges, and a stored flow is feasible. A file that fails is rejected as corrupt.
+     *
+     * @param path The snapshot to map.
+     * @param source Receives the recorded source vertex.
+     * @param sink Receives the recorded sink vertex.
+     * @param error Receives the reason on failure.
+     * @return true on success.
+     */
+    bool map_snapshot(const string &path, int &source, int &sink, string &error);
+
+    // method to add an edge to the graph
+    /**
+     * @brief Add an edge to the graph with the given source, destination, and capacity.
+     *
+     * @param u The source vertex of the edge.
+     * @param v The destination vertex of the edge.
+     * @param capacity The capacity of the edge.
+     * @param cost The cost per unit of flow, only used by min_cost_flow.
+     * @return The index of the new edge.
+     */
+    int add_edge(int u, int v, Cap capacity, long long cost = 0);
+
+    /**
+     * @brief Changes the capacity of an edge and keeps as much of its flow as still fits.
+     *
+     * Flow above the new capacity is dropped from the edge, which leaves its tail with
+     * surplus and its head with a deficit until the next solve repairs them.
+     *
+     * @param edge The index of the edge.
+     * @param capacity The new capacity, at least 0.
+     */
+    void set_capacity(int edge, Cap capacity);
+
+    // method to remove an edge: it keeps its index but gets capacity 0 and leaves cut listings
+    void remove_edge(int edge);
+
+    /**
+     * @brief Rebalances the flow after capacity decreases so a solve can start from it.
+     *
+     * The surplus and deficit left by set_capacity and remove_edge are routed to each other,
+     * or back to the source and sink, along residual paths searched outwards from the touched
+     * vertices. max_flow and min_cut_value call it first, so a re-solve after a small update
+     * costs the repair paths, one pass over the arcs and the augmentations the update allows.
+     * The repair only applies to the pair the flow was solved for: a solve for another pair
+     * drops the flow and the imbalance left by the updates together.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     */
+    void repair_flow(int source, int sink);
+    bool repair_path(int from, int source, int sink, bool forward);
+
+    /**
+     * @brief Zeroes Edge::flow and the pending imbalance when they belong to another source-sink pair.
+     *
+     * A flow is only conserved away from its own source and sink, so it is no starting point
+     * for a different pair. Unlike solved_source, which every update clears, flow_source
+     * survives set_capacity and add_edge, since their repairs keep the flow valid for its pair.
+     *
+     * @param source The source vertex of the coming solve.
+     * @param sink The sink vertex of the coming solve.
+     */
+    void start_flow(int source, int sink);
+
+    // method to calculate the net flow leaving the source in the current arcs
+    Flow flow_value(int source) const;
+
+    /**
+     * @brief Checks that no sum the engines form can overflow Flow.
+     *
+     * Every excess, path flow and flow value is bounded by the total capacity into or out of
+     * a single vertex, so it is enough to add those up once per vertex with overflow checks.
+     * The loaders call it, code that builds a graph by hand should too.
+     *
+     * @param error Receives the first edge whose capacity overflows a sum.
+     * @return true if the capacities into and out of every vertex fit in Flow.
+     */
+    bool check_capacities(string &error) const;
+
+    // method to lay out the arcs of the residual graph
+    /**
+     * @brief Lays out the forward and reverse arcs of every edge in compressed sparse row order.
+     *
+     * Runs a counting sort over the edge list, so it costs O(n + E) time and memory.
+     */
+    void build_csr();
+
+    /**
+     * @brief Returns the residual capacity of an arc.
+     *
+     * @param a The index of the arc.
+     * @return The remaining capacity c(a) - f(a).
+     */
+    Flow residual(int a) const
+    {
+        if (CapacityTraits<Cap>::unit)
+        {
+            return (arc_bits[a >> 6] >> (a & 63)) & 1;
+        }
+        return arc_cap[a] - arc_flow[a];
+    }
+
+    /**
+     * @brief Moves d units of flow along arc a and takes them off its reverse arc.
+     *
+     * @param a The index of the arc.
+     * @param d The amount, at most residual(a).
+     */
+    void push_flow(int a, Flow d)
+    {
+        if (CapacityTraits<Cap>::unit)
+        {
+            // a unit pair has residual 1 on exactly one side before and after the push
+            if (d)
+            {
+                arc_bits[a >> 6] ^= 1ULL << (a & 63);
+                arc_bits[arc_rev[a] >> 6] ^= 1ULL << (arc_rev[a] & 63);
+            }
+            return;
+        }
+        arc_flow[a] += d;
+        arc_flow[arc_rev[a]] -= d;
+    }
+
+    // method to read the capacity of an arc, 0 for reverse arcs
+    Cap arc_capacity(int a) const
+    {
+        if (CapacityTraits<Cap>::unit)
+        {
+            return arc_edge[a] >= 0 && edges[arc_edge[a]].capacity;
+        }
+        return arc_cap[a];
+    }
+
+    // method to read the flow on an arc, negative on reverse arcs
+    Flow arc_flow_of(int a) const { return arc_capacity(a) - residual(a); }
+
+    // method to set the flow on a single arc, its reverse arc has to be set to match
+    void set_arc_flow(int a, Flow flow)
+    {
+        if (CapacityTraits<Cap>::unit)
+        {
+            uint64_t bit = 1ULL << (a & 63);
+            arc_bits[a >> 6] = arc_capacity(a) - flow ? arc_bits[a >> 6] | bit : arc_bits[a >> 6] & ~bit;
+            return;
+        }
+        arc_flow[a] = flow;
+    }
+
+    // method to set the capacity and the flow of the forward arc a and its reverse arc
+    void set_arc(int a, Cap capacity, Cap flow)
+    {
+        if (!CapacityTraits<Cap>::unit)
+        {
+            arc_cap[a] = capacity;
+            arc_cap[arc_rev[a]] = 0;
+        }
+        set_arc_flow(a, flow);
+        set_arc_flow(arc_rev[a], -(Flow)flow);
+    }
+
+    // method to read the cost of an arc, the negated edge cost on reverse arcs
+    long long arc_cost(int a) const
+    {
+        if (edge_cost.empty())
+        {
+            return 0;
+        }
+        return arc_edge[a] >= 0 ? edge_cost[arc_edge[a]] : -edge_cost[~arc_edge[a]];
+    }
+
+    // method to create the residual graph from the original graph
+    /**
+     * @brief Creates the residual graph of the current graph.
+     *
+     * Only needed before a solve: augmentations update the arcs on the path in place.
+     */
+    void create_residual_graph();
+
+    // methods to mark vertices visited without clearing an n-length array per search
+    /**
+     * @brief Starts a new search: every vertex becomes unvisited in O(1).
+     */
+    void start_search();
+    bool is_visited(int v) const { return visit_mark[v] == visit_epoch; }
+    void mark_visited(int v)
+    {
+        visit_mark[v] = visit_epoch;
+        FLOW_STAT(stats.vertices_visited++; stats.max_visited = max(stats.max_visited, ++stats.search_visited));
+    }
+
+    // method to find an augmenting path in the residual graph using DFS
+    /**
+     * @brief Performs a depth-first search (DFS) to find an augmenting path in the residual graph.
+     *
+     * Uses an explicit stack, so long paths cannot overflow the call stack.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param delta The smallest residual capacity an arc on the path may have.
+     * @return true if an augmenting path is found, false otherwise. The path is left in parent_arc.
+     */
+    bool dfs(int source, int sink, Flow delta);
+
+    // method to find a shortest augmenting path in the residual graph using BFS
+    bool bfs(int source, int sink, Flow delta);
+
+    /**
+     * @brief Finds an augmenting path with DFS, or with BFS when the algorithm is EDMONDS_KARP.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param delta The smallest residual capacity an arc on the path may have, 1 for any path.
+     * @return true if a path was found. parent_arc[v] is then the arc entering v on the path.
+     */
+    bool find_augmenting_path(int source, int sink, Flow delta);
+
+    // method to run the selected max-flow engine on the graph
+    /**
+     * @brief Calculates the maximum flow from source to sink with the engine chosen in `algorithm`.
+     *
+     * When the edges carry a flow for the same source and sink, every engine starts from it,
+     * so after set_capacity, add_edge or remove_edge the previous solution is repaired and
+     * augmented instead of being recomputed from zero. A flow solved for any other pair is
+     * dropped first (see start_flow), as it is not conserved at that pair's terminals.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The maximum flow in the graph, the flow of every edge is left in Edge::flow; 0 if source == sink.
+     */
+    Flow max_flow(int source, int sink);
+
+    // method to run the Ford-Fulkerson algorithm (Edmonds-Karp with BFS) on the graph
+    /**
+     * @brief Calculates the maximum flow by repeatedly augmenting along residual paths.
+     *
+     * With capacity_scaling the search is restricted to arcs with residual at least delta,
+     * starting from the largest power of two not above the largest capacity and halving
+     * delta once no such path is left. This bounds the augmentations to O(E log U).
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The maximum flow in the graph.
+     */
+    Flow ford_fulkerson(int source, int sink);
+
+    // methods to run Dinic's algorithm on the graph
+    /**
+     * @brief Calculates the maximum flow with Dinic's algorithm.
+     *
+     * Every phase builds the BFS level graph and saturates it with a blocking flow, using a
+     * current-arc pointer per vertex so no arc is scanned twice in a phase. O(V^2 E) in general
+     * and O(E sqrt(V)) on unit capacity networks.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The maximum flow in the graph.
+     */
+    Flow dinic(int source, int sink);
+    bool build_levels(int source, int sink, vector<int> &level);
+    Flow blocking_flow(int source, int sink, vector<int> &level, vector<int> &current);
+
+    // methods to run the highest-label push-relabel algorithm on the graph
+    /**
+     * @brief Calculates the maximum flow with highest-label push-relabel.
+     *
+     * Phase one discharges the active vertex with the highest label until no active vertex
+     * can reach the sink, which leaves a maximum preflow. Phase two returns the excess that
+     * is stranded on the source side to the source so the arcs hold a valid flow again.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param convert_to_flow false to stop after phase one.
+     * @return The maximum flow in the graph.
+     */
+    Flow push_relabel(int source, int sink, bool convert_to_flow);
+    void init_preflow(int source);
+    void global_relabel(int source, int sink);
+    void discharge(int u, int sink);
+    void relabel(int u);
+    void add_active(int u);
+    void add_label(int u);
+    void remove_label(int u);
+    void return_excess(int source, int sink);
+
+    // methods to run push-relabel on several threads
+    /**
+     * @brief Calculates the maximum flow with a lock-free parallel push-relabel on `threads` threads.
+     *
+     * Each thread discharges the vertices it owns by pushing to the lowest residual neighbour
+     * or relabeling, with atomic flow and excess updates, so labels read from other threads may
+     * be stale without breaking correctness. Work runs in epochs separated by a global relabel;
+     * the preflow is turned into a flow by the sequential return_excess.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param convert_to_flow false to stop after the preflow phase.
+     * @return The maximum flow in the graph.
+     */
+    Flow parallel_push_relabel(int source, int sink, bool convert_to_flow);
+    void parallel_worker(ParallelPushRelabelState<Flow> *state);
+    void parallel_discharge(ParallelPushRelabelState<Flow> *state, int u, vector<int> &local);
+
+    /**
+     * @brief Calculates the value of a minimum s-t cut.
+     *
+     * With PUSH_RELABEL only the preflow phase runs, so the arcs hold a preflow and
+     * Edge::flow is left untouched. The other engines run a full max_flow.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The capacity of a minimum s-t cut, 0 if source == sink.
+     */
+    Flow min_cut_value(int source, int sink);
+
+    /**
+     * @brief Calculates a maximum flow of least total cost with the engine chosen in `cost_algorithm`.
+     *
+     * Both engines run on the same residual arcs as max_flow and start from zero flow.
+     * SUCCESSIVE_SHORTEST_PATHS keeps Johnson potentials so every search is a Dijkstra over
+     * non-negative reduced costs with a binary heap, then augments along all the shortest
+     * paths it found. Negative costs are allowed, a Bellman-Ford pass sets the first
+     * potentials, but a cycle of negative cost makes it give up. COST_SCALING finds a max
+     * flow with `algorithm` and cancels its cost with push-relabel over eps-optimal prices,
+     * dividing eps by 8 per round, O(V^2 E log(VC)); it also handles negative cycles.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param cost Receives the total cost of the flow.
+     * @return The maximum flow, left in Edge::flow, or -1 if a negative cost cycle stopped the search.
+     */
+    Flow min_cost_flow(int source, int sink, long long &cost);
+    Flow successive_shortest_paths(int source, int sink);
+    bool shortest_path_potentials(vector<long long> &potential);
+    Flow cost_scaling(int source, int sink);
+    void refine(long long eps, vector<long long> &price);
+
+    // method to add up edge cost times edge flow
+    long long flow_cost() const;
+
+    // method to copy the flow on the arcs back to the edges
+    void store_edge_flows();
+
+    /**
+     * @brief Extracts a minimum s-t cut from the solved arcs.
+     *
+     * Solves first only if the last max_flow or min_cut_value was for another pair or the
+     * graph changed since. After a flow the source side is what the source reaches in the
+     * residual graph. After the preflow of min_cut_value, where vertices may still hold
+     * excess, the sink side is what reaches the sink instead. Either way one iterative
+     * search and one pass over the edges, O(V + E).
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @return The cut value, both sides and the crossing edges; an empty cut if source == sink.
+     */
+    CutResult min_cut(int source, int sink);
+
+    /**
+     * @brief Splits the flow in Edge::flow into source-sink paths and cycles.
+     *
+     * A virtual sink-source edge carrying the flow value closes the flow into a circulation.
+     * A walk follows the first edge of every vertex that still has flow left, through a
+     * per-vertex cursor that only moves past edges whose flow is used up, so no edge is
+     * scanned twice. Coming back to a vertex already on the walk closes a cycle, which is
+     * emitted as a source-sink path if it uses the virtual edge. Every piece subtracts its
+     * bottleneck and so empties at least one edge, giving at most E + 1 pieces in O(VE)
+     * time. The flow has to be conserved, as max_flow leaves it.
+     *
+     * @param source The source vertex.
+     * @param sink The sink vertex.
+     * @param out Receives every path and cycle as soon as it is found.
+     * @return The number of pieces emitted.
+     */
+    long long decompose_flow(int source, int sink, FlowPathSink<Flow> &out);
+
+    // method to implement st_cut, the (u, v) pairs of the min_cut edges
+    vector<pair<int, int>> st_cut(int source, int sink);
+
+    //helper function for the st_cut, marks every vertex reachable from u in the residual graph as visited
+    void dfs_cut(int u);
+
+    // helper function for min_cut after a preflow, marks every vertex that reaches u in the residual graph as visited
+    void dfs_cut_reverse(int u);
+
+    ~BasicGraph();
+
+private:
+    BasicGraph(const BasicGraph &);
+    BasicGraph &operator=(const BasicGraph &);
+};
+
+typedef BasicGraph<int> Graph;           // int capacities, the default
+typedef BasicGraph<long long> Graph64;   // 64-bit capacities for aggregated graphs
+typedef BasicGraph<bool> UnitGraph;      // 0/1 capacities, one residual bit per arc
+
+/**
+ * @brief Loads a graph in the inputTask1.txt format: n, then source and sink, then one `u v capacity` edge per line.
+ *
+ * The file is memory-mapped. A first pass counts the lines so the edges and the arcs are
+ * allocated exactly once, a second pass parses the integers by hand. Parsing stops at the
+ * first malformed line instead of silently dropping the rest of the file. An optional
+ * fourth column gives the cost per unit of flow of the edge for min_cost_flow.
+ *
+ * @param path The file to read.
+ * @param G Receives the graph, reset to the vertex count of the file.
+ * @param source Receives the source vertex.
+ * @param sink Receives the sink vertex.
+ * @param error Receives "path:line: message" on failure.
+ * @return true on success.
+ */
+template <class Cap>
+bool load_edge_list(const string &path, BasicGraph<Cap> &G, int &source, int &sink, string &error);
+
+/**
+ * @brief Loads a graph from a binary edge list (EdgeListHeader followed by the edge records).
+ *
+ * The records are 32-bit, so capacities above INT_MAX need a text edge list even with Graph64.
+ *
+ * @param path The file to read.
+ * @param G Receives the graph, reset to the vertex count of the file.
+ * @param source Receives the source vertex.
+ * @param sink Receives the sink vertex.
+ * @param error Receives the reason on failure.
+ * @return true on success.
+ */
+template <class Cap>
+bool load_binary_edges(const string &path, BasicGraph<Cap> &G, int &source, int &sink, string &error);
+
+/**
+ * @brief Loads a graph from a binary snapshot, a binary edge list or, failing both magic checks, a text edge list.
+ *
+ * Capacities above the largest value of Cap, and graphs that fail check_capacities, are
+ * rejected with an error instead of overflowing during the solve.
+ *
+ * @param path The file to read.
+ * @param G Receives the graph.
+ * @param source Receives the source vertex.
+ * @param sink Receives the sink vertex.
+ * @param error Receives the reason on failure.
+ * @return true on success.
+ */
+template <class Cap>
+bool load_graph(const string &path, BasicGraph<Cap> &G, int &source, int &sink, string &error);
+
+#endif
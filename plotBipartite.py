@@ -1,58 +1,35 @@
+import json
+import sys
 import networkx as nx
 import matplotlib.pyplot as plt
 
+# read the result bipartite_modified exported, resultBipartite.json unless another file is given
+path = sys.argv[1] if len(sys.argv) > 1 else "resultBipartite.json"
+with open(path, "r") as f:
+    result = json.load(f)
 
-
-uset=[]
-vset=[]
-# read data from file
-with open("inputBipartite.txt", "r") as f:
-    n = int(f.readline())-1  # number of vertices
-    edges = []
-    # f.readline()
-    for line in f:
-        u, v = map(int, line.strip().split())
-        edges.append((u, v))
-        uset.append(u)
-        vset.append(v)
+# left and right ids overlap, so the nodes are ('u', id) and ('v', id)
+uset = sorted(set(('u', e["u"]) for e in result["edges"]))
+vset = sorted(set(('v', e["v"]) for e in result["edges"]))
+edges = [(('u', e["u"]), ('v', e["v"])) for e in result["edges"]]
+matched = [(('u', e["u"]), ('v', e["v"])) for e in result["edges"] if e["matched"]]
 
 # create graph
 G = nx.Graph()
-G.add_nodes_from(uset, bipartite=0)  # nodes 1-4 belong to partition 0
-G.add_nodes_from(vset, bipartite=1)    # nodes 5-7 belong to partition 1
+G.add_nodes_from(uset, bipartite=0)
+G.add_nodes_from(vset, bipartite=1)
 G.add_edges_from(edges)
 
 # create bipartite layout
 pos = nx.bipartite_layout(G, uset)
 
-# draw graph
+# draw graph with the matched edges in red
 nx.draw_networkx_nodes(G, pos, nodelist=uset, node_color='y', node_size=500)
 nx.draw_networkx_nodes(G, pos, nodelist=vset, node_color='m', node_size=500)
 nx.draw_networkx_edges(G, pos, edge_color='k')
-nx.draw_networkx_labels(G, pos, font_size=20, font_family='sans-serif')
+nx.draw_networkx_edges(G, pos, edgelist=matched, edge_color='r', width=3)
+nx.draw_networkx_labels(G, pos, labels={v: v[1] for v in G.nodes()}, font_size=20, font_family='sans-serif')
+# an --assign export carries the total weight of the matching instead of its size
+plt.title(("total weight %d" if result["kind"] == "assignment" else "matching size %d") % result["value"])
 plt.axis('off')
 plt.show()
-
-
-# import networkx as nx
-# import matplotlib.pyplot as plt
-
-# # create bipartite graph
-# G = nx.Graph()
-
-# # G.add_edges_from([(1, 5), (1, 6), (2, 5), (3, 6), (4, 7)])  # add edges
-
-# # get position of nodes in bipartite layout
-
-
-# # draw nodes
-# nx.draw_networkx_nodes(G, pos, nodelist=[1, 2, 3, 4], node_size=500)
-# nx.draw_networkx_nodes(G, pos, nodelist=[5, 6, 7], node_color='b', node_size=500)
-
-# # draw edges and labels
-# nx.draw_networkx_edges(G, pos)
-# nx.draw_networkx_labels(G, pos)
-
-# # show plot
-# plt.axis('off')
-# plt.show()
\ No newline at end of file
@@ -1,24 +1,29 @@
+import json
+import sys
 import networkx as nx
 import matplotlib.pyplot as plt
 
-# read data from file
-with open("inputTask1.txt", "r") as f:
-    n = int(f.readline())-1  # number of vertices
-    edges = []
-    f.readline()
-    for line in f:
-        u, v ,x= map(int, line.strip().split())
-        edges.append((u, v))
+# read the result FF_modified exported, resultTask1.json unless another file is given
+path = sys.argv[1] if len(sys.argv) > 1 else "resultTask1.json"
+with open(path, "r") as f:
+    result = json.load(f)
 
 # create graph
 G = nx.DiGraph()
-G.add_nodes_from(range(1, n+1))
-G.add_edges_from(edges)
+G.add_nodes_from(range(result["vertices"]))
+for e in result["edges"]:
+    G.add_edge(e["u"], e["v"])
+cut = [(e["u"], e["v"]) for e in result["edges"] if e["cut"]]
+labels = {(e["u"], e["v"]): "%d/%d" % (e["flow"], e["capacity"]) for e in result["edges"]}
+source_side = set(result.get("source_side", []))
 
-# draw graph
+# draw graph, the source side of the min cut in blue and the saturated cut edges in red
 pos = nx.spring_layout(G)
-nx.draw_networkx_nodes(G, pos, node_size=500)
+nx.draw_networkx_nodes(G, pos, node_size=500, node_color=['c' if v in source_side else 'y' for v in G.nodes()])
 nx.draw_networkx_edges(G, pos, edge_color='y')
+nx.draw_networkx_edges(G, pos, edgelist=cut, edge_color='r', width=2)
+nx.draw_networkx_edge_labels(G, pos, edge_labels=labels, font_size=8)
 nx.draw_networkx_labels(G, pos, font_size=10, font_family='sans-serif')
+plt.title("max flow %d" % result["value"])
 plt.axis('off')
 plt.show()
@@ -0,0 +1,320 @@
+#include "reduction.h"
+
+/**
+ * @brief An edge of the network while it is being reduced, standing for one part.
+ */
+struct ReductionArc
+{
+    int tail, head, part;
+
+    bool operator<(const ReductionArc &other) const
+    {
+        return tail != other.tail ? tail < other.tail : head < other.head;
+    }
+};
+
+// edges of G leaving (by_head false) or entering (by_head true) every vertex, by a counting sort
+template <class Cap>
+static void index_edges(const BasicGraph<Cap> &G, bool by_head, vector<int> &first, vector<int> &order)
+{
+    first.assign(G.n + 1, 0);
+    for (int i = 0; i < G.m; i++)
+    {
+        first[(by_head ? G.edges[i].v : G.edges[i].u) + 1]++;
+    }
+    for (int v = 0; v < G.n; v++)
+    {
+        first[v + 1] += first[v];
+    }
+    order.resize(G.m);
+    vector<int> pos(first.begin(), first.end() - 1);
+    for (int i = 0; i < G.m; i++)
+    {
+        order[pos[by_head ? G.edges[i].v : G.edges[i].u]++] = i;
+    }
+}
+
+// marks every vertex reachable from start over positive capacity edges, against their direction if backward
+template <class Cap>
+static void reach(const BasicGraph<Cap> &G, int start, bool backward, const vector<int> &first, const vector<int> &order,
+                  vector<char> &seen)
+{
+    seen.assign(G.n, 0);
+    vector<int> stack(1, start);
+    seen[start] = 1;
+    while (!stack.empty())
+    {
+        int u = stack.back();
+        stack.pop_back();
+        for (int k = first[u]; k < first[u + 1]; k++)
+        {
+            const BasicEdge<Cap> &e = G.edges[order[k]];
+            int v = backward ? e.u : e.v;
+            if (!seen[v] && e.capacity > 0)
+            {
+                seen[v] = 1;
+                stack.push_back(v);
+            }
+        }
+    }
+}
+
+template <class Cap>
+FlowReduction<Cap>::FlowReduction()
+{
+    source = sink = -1;
+    pruned = merged = contracted = 0;
+}
+
+template <class Cap>
+int FlowReduction<Cap>::add_part(bool series, const vector<int> &children)
+{
+    int p = part_series.size();
+    part_series.push_back(series);
+    first_part.push_back(-1);
+    next_part.push_back(-1);
+    Flow capacity = part_capacity[children[0]];
+    for (size_t i = 1; i < children.size(); i++)
+    {
+        capacity = series ? min(capacity, part_capacity[children[i]]) : capacity + part_capacity[children[i]];
+    }
+    for (int i = (int)children.size() - 1; i >= 0; i--)
+    {
+        next_part[children[i]] = first_part[p];
+        first_part[p] = children[i];
+    }
+    part_capacity.push_back(capacity);
+    return p;
+}
+
+template <class Cap>
+void FlowReduction<Cap>::reduce(const BasicGraph<Cap> &G, int source, int sink, Reduced &R)
+{
+    int n = G.n;
+    part_series.assign(G.m, 0);
+    part_capacity.resize(G.m);
+    first_part.assign(G.m, -1);
+    next_part.assign(G.m, -1);
+    for (int i = 0; i < G.m; i++)
+    {
+        part_capacity[i] = G.edges[i].capacity;
+    }
+
+    // only vertices on some source-sink path can carry flow
+    vector<int> first, order;
+    vector<char> from_source, to_sink;
+    index_edges(G, false, first, order);
+    reach(G, source, false, first, order, from_source);
+    index_edges(G, true, first, order);
+    reach(G, sink, true, first, order, to_sink);
+    vector<char> alive(n);
+    pruned = 0;
+    for (int v = 0; v < n; v++)
+    {
+        alive[v] = (from_source[v] && to_sink[v]) || v == source || v == sink;
+        pruned += !alive[v];
+    }
+    vector<ReductionArc> arcs;
+    for (int i = 0; i < G.m; i++)
+    {
+        const BasicEdge<Cap> &e = G.edges[i];
+        if (e.capacity > 0 && e.u != e.v && alive[e.u] && alive[e.v] && e.v != source && e.u != sink)
+        {
+            ReductionArc arc = {e.u, e.v, i};
+            arcs.push_back(arc);
+        }
+    }
+
+    // merge parallel edges, then contract the chains, until neither changes anything
+    merged = contracted = 0;
+    vector<int> in_degree(n), out_degree(n), out_arc(n), children;
+    vector<char> used;
+    vector<ReductionArc> next;
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+        sort(arcs.begin(), arcs.end());
+        next.clear();
+        for (size_t i = 0, j; i < arcs.size(); i = j)
+        {
+            children.clear();
+            for (j = i; j < arcs.size() && arcs[j].tail == arcs[i].tail && arcs[j].head == arcs[i].head; j++)
+            {
+                children.push_back(arcs[j].part);
+            }
+            ReductionArc arc = arcs[i];
+            if (children.size() > 1)
+            {
+                arc.part = add_part(false, children);
+                merged += children.size() - 1;
+                changed = true;
+            }
+            next.push_back(arc);
+        }
+        arcs.swap(next);
+
+        fill(in_degree.begin(), in_degree.end(), 0);
+        fill(out_degree.begin(), out_degree.end(), 0);
+        for (int i = 0; i < (int)arcs.size(); i++)
+        {
+            in_degree[arcs[i].head]++;
+            out_degree[arcs[i].tail]++;
+            out_arc[arcs[i].tail] = i;
+        }
+        used.assign(arcs.size(), 0);
+        next.clear();
+        for (int i = 0; i < (int)arcs.size(); i++)
+        {
+            int x = arcs[i].head;
+            bool chain_start = arcs[i].tail != source && arcs[i].tail != sink && in_degree[arcs[i].tail] == 1 && out_degree[arcs[i].tail] == 1;
+            if (x == source || x == sink || in_degree[x] != 1 || out_degree[x] != 1 || chain_start)
+            {
+                continue;
+            }
+            // walk the chain from a vertex that stays to the next one that stays
+            children.assign(1, arcs[i].part);
+            used[i] = 1;
+            while (x != source && x != sink && in_degree[x] == 1 && out_degree[x] == 1 && !used[out_arc[x]])
+            {
+                int j = out_arc[x];
+                used[j] = 1;
+                children.push_back(arcs[j].part);
+                alive[x] = 0;
+                contracted++;
+                x = arcs[j].head;
+            }
+            if (x != arcs[i].tail)
+            {
+                ReductionArc arc = {arcs[i].tail, x, add_part(true, children)};
+                next.push_back(arc);
+            }
+            changed = true;
+        }
+        for (int i = 0; i < (int)arcs.size(); i++)
+        {
+            if (!used[i])
+            {
+                next.push_back(arcs[i]);
+            }
+        }
+        arcs.swap(next);
+    }
+
+    // number the vertices that stay in their original order
+    reduced_vertex.assign(n, -1);
+    original_vertex.clear();
+    for (int v = 0; v < n; v++)
+    {
+        if (alive[v])
+        {
+            reduced_vertex[v] = original_vertex.size();
+            original_vertex.push_back(v);
+        }
+    }
+    this->source = reduced_vertex[source];
+    this->sink = reduced_vertex[sink];
+    R.reset(original_vertex.size());
+    R.reserve_edges(arcs.size());
+    edge_part.resize(arcs.size());
+    for (int i = 0; i < (int)arcs.size(); i++)
+    {
+        R.add_edge(reduced_vertex[arcs[i].tail], reduced_vertex[arcs[i].head], part_capacity[arcs[i].part]);
+        edge_part[i] = arcs[i].part;
+    }
+}
+
+template <class Cap>
+void FlowReduction<Cap>::expand_flow(const Reduced &R, BasicGraph<Cap> &G) const
+{
+    for (int i = 0; i < G.m; i++)
+    {
+        G.edges[i].flow = 0;
+    }
+    vector<pair<int, Flow>> stack;
+    for (int j = 0; j < R.m; j++)
+    {
+        if (R.edges[j].flow > 0)
+        {
+            stack.push_back(make_pair(edge_part[j], R.edges[j].flow));
+        }
+    }
+    G.flow_source = original_vertex[source];
+    G.flow_sink = original_vertex[sink];
+    while (!stack.empty())
+    {
+        int p = stack.back().first;
+        Flow f = stack.back().second;
+        stack.pop_back();
+        if (p < G.m)
+        {
+            G.edges[p].flow = f;
+            continue;
+        }
+        for (int c = first_part[p]; c >= 0 && f > 0; c = next_part[c])
+        {
+            Flow share = part_series[p] ? f : min(f, part_capacity[c]);
+            stack.push_back(make_pair(c, share));
+            if (!part_series[p])
+            {
+                f -= share;
+            }
+        }
+    }
+}
+
+template <class Cap>
+CutResult FlowReduction<Cap>::min_cut(const BasicGraph<Cap> &G, int source) const
+{
+    vector<int> first_out, out_edges, first_in, in_edges;
+    index_edges(G, false, first_out, out_edges);
+    index_edges(G, true, first_in, in_edges);
+
+    // residual search: forward along unsaturated edges, backward along edges with flow
+    vector<char> side(G.n, 0);
+    vector<int> stack(1, source);
+    side[source] = 1;
+    while (!stack.empty())
+    {
+        int u = stack.back();
+        stack.pop_back();
+        for (int k = first_out[u]; k < first_out[u + 1]; k++)
+        {
+            const BasicEdge<Cap> &e = G.edges[out_edges[k]];
+            if (!side[e.v] && e.flow < e.capacity)
+            {
+                side[e.v] = 1;
+                stack.push_back(e.v);
+            }
+        }
+        for (int k = first_in[u]; k < first_in[u + 1]; k++)
+        {
+            const BasicEdge<Cap> &e = G.edges[in_edges[k]];
+            if (!side[e.u] && e.flow > 0)
+            {
+                side[e.u] = 1;
+                stack.push_back(e.u);
+            }
+        }
+    }
+
+    CutResult cut;
+    cut.value = 0;
+    for (int v = 0; v < G.n; v++)
+    {
+        (side[v] ? cut.source_side : cut.sink_side).push_back(v);
+    }
+    for (int i = 0; i < G.m; i++)
+    {
+        if (side[G.edges[i].u] && !side[G.edges[i].v] && G.edges[i].capacity > 0)
+        {
+            cut.edges.push_back(i);
+            cut.value += G.edges[i].capacity;
+        }
+    }
+    return cut;
+}
+
+template class FlowReduction<int>;
+template class FlowReduction<long long>;
+template class FlowReduction<bool>;
@@ -0,0 +1,81 @@
+#ifndef REDUCTION_H
+#define REDUCTION_H
+
+#include <vector>
+#include "maxflow.h"
+using namespace std;
+
+/**
+ * @brief Shrinks a flow network before solving and maps the solution back onto it.
+ *
+ * Vertices the source cannot reach or that cannot reach the sink carry no flow in some
+ * maximum flow, so they are pruned along with self loops, zero capacity edges, edges into
+ * the source and edges out of the sink. Parallel edges are merged into one with the summed
+ * capacity, and a chain through vertices with a single edge in and a single edge out becomes
+ * one edge with the smallest capacity of the chain. Merging and contracting repeat until
+ * neither applies.
+ *
+ * Every reduced edge is a series-parallel composition of original edges, kept as a tree of
+ * parts, so a reduced flow expands to original edge flows in O(E).
+ */
+template <class Cap>
+class FlowReduction
+{
+public:
+    typedef typename CapacityTraits<Cap>::Flow Flow;
+    typedef BasicGraph<Flow> Reduced; // merged capacities may not fit Cap, a unit network reduces to int
+
+    int source, sink;            // source and sink of the reduced graph
+    vector<int> reduced_vertex;  // reduced id of every original vertex, -1 if it was pruned or contracted
+    vector<int> original_vertex; // original id of every reduced vertex
+    vector<int> edge_part;       // part every reduced edge expands to
+
+    // Parts 0 .. m - 1 are the original edges, later ones merge the parts listed from first_part via next_part
+    vector<char> part_series;    // true if the part is a chain of its children, false if they run in parallel
+    vector<Flow> part_capacity;
+    vector<int> first_part, next_part;
+
+    long long pruned;     // vertices removed by the reachability tests
+    long long merged;     // edges folded into a parallel edge
+    long long contracted; // chain vertices removed
+
+    FlowReduction();
+
+    /**
+     * @brief Builds the reduced network of G for the given source and sink.
+     *
+     * @param G The original graph, its flows are ignored.
+     * @param source The source vertex of G.
+     * @param sink The sink vertex of G, different from the source.
+     * @param R Receives the reduced graph, with the source and sink in this->source and this->sink.
+     */
+    void reduce(const BasicGraph<Cap> &G, int source, int sink, Reduced &R);
+
+    /**
+     * @brief Writes the flow R holds back into Edge::flow of the original edges.
+     *
+     * Series parts pass their flow to every child, parallel parts fill their children one
+     * after another. Edges that were pruned get no flow.
+     *
+     * @param R The solved reduced graph.
+     * @param G The original graph.
+     */
+    void expand_flow(const Reduced &R, BasicGraph<Cap> &G) const;
+
+    /**
+     * @brief Extracts a minimum s-t cut of G in original vertex ids from the expanded flow.
+     *
+     * The source side is what the source reaches in the residual graph of the edge flows,
+     * found with one search over an adjacency built for it, O(V + E).
+     *
+     * @param G The original graph after expand_flow.
+     * @param source The source vertex of G.
+     * @return The cut value, both sides and the crossing edges.
+     */
+    CutResult min_cut(const BasicGraph<Cap> &G, int source) const;
+
+    // method to add a part over the given children and return its index
+    int add_part(bool series, const vector<int> &children);
+};
+
+#endif
@@ -0,0 +1,271 @@
+#include "result_export.h"
+#include <cstring>
+#include <cerrno>
+
+ResultWriter::ResultWriter()
+{
+    file = nullptr;
+    format = EXPORT_JSON;
+    written = 0;
+    failed = false;
+    closing = false;
+    memset(&header, 0, sizeof(header));
+}
+
+ResultWriter::~ResultWriter()
+{
+    string error;
+    finish(error);
+}
+
+ExportFormat export_format_of(const string &path)
+{
+    size_t dot = path.rfind('.');
+    string extension = dot == string::npos ? "" : path.substr(dot);
+    if (extension == ".dot")
+    {
+        return EXPORT_DOT;
+    }
+    if (extension == ".bin")
+    {
+        return EXPORT_BINARY;
+    }
+    return EXPORT_JSON;
+}
+
+bool ResultWriter::open(const string &path, ExportFormat format, string &error)
+{
+    file = fopen(path.c_str(), format == EXPORT_BINARY ? "wb" : "w");
+    if (!file)
+    {
+        error = path + ": " + strerror(errno);
+        return false;
+    }
+    this->path = path;
+    this->format = format;
+    writer = thread(&ResultWriter::run, this);
+    return true;
+}
+
+void ResultWriter::push(Block &block)
+{
+    if (!file)
+    {
+        return;
+    }
+    lock_guard<mutex> guard(queue_lock);
+    queue.push_back(Block());
+    queue.back().type = block.type;
+    queue.back().header = block.header;
+    queue.back().records.swap(block.records);
+    queue.back().sides.swap(block.sides);
+    queue_signal.notify_one();
+}
+
+void ResultWriter::begin(uint32_t kind, int n, int source, int sink, long long value, long long m)
+{
+    Block block;
+    block.type = BEGIN;
+    memset(&block.header, 0, sizeof(block.header));
+    memcpy(block.header.magic, "FFGRSLT", 8);
+    block.header.version = RESULT_VERSION;
+    block.header.byte_order = 0x01020304;
+    block.header.kind = kind;
+    block.header.n = n;
+    block.header.source = source;
+    block.header.sink = sink;
+    block.header.value = value;
+    block.header.m = m;
+    push(block);
+}
+
+void ResultWriter::add_edges(vector<ResultRecord> &batch)
+{
+    Block block;
+    block.type = EDGES;
+    block.records.swap(batch);
+    push(block);
+}
+
+void ResultWriter::add_sides(vector<char> &sides)
+{
+    Block block;
+    block.type = SIDES;
+    block.sides.swap(sides);
+    push(block);
+}
+
+void ResultWriter::end()
+{
+    Block block;
+    block.type = END;
+    push(block);
+}
+
+bool ResultWriter::finish(string &error)
+{
+    if (!file)
+    {
+        return true;
+    }
+    {
+        lock_guard<mutex> guard(queue_lock);
+        closing = true;
+        queue_signal.notify_one();
+    }
+    writer.join();
+    if (fclose(file) != 0)
+    {
+        failed = true;
+    }
+    file = nullptr;
+    if (failed)
+    {
+        error = path + ": write failed";
+    }
+    return !failed;
+}
+
+void ResultWriter::run()
+{
+    for (;;)
+    {
+        Block block;
+        {
+            unique_lock<mutex> guard(queue_lock);
+            queue_signal.wait(guard, [this] { return !queue.empty() || closing; });
+            if (queue.empty())
+            {
+                return;
+            }
+            block.type = queue.front().type;
+            block.header = queue.front().header;
+            block.records.swap(queue.front().records);
+            block.sides.swap(queue.front().sides);
+            queue.pop_front();
+        }
+        write_block(block);
+    }
+}
+
+void ResultWriter::write_text(const string &text)
+{
+    if (fwrite(text.data(), 1, text.size(), file) != text.size())
+    {
+        failed = true;
+    }
+}
+
+void ResultWriter::write_block(const Block &block)
+{
+    bool matching = header.kind != RESULT_FLOW, weighted = header.kind == RESULT_ASSIGNMENT;
+    char line[160];
+    string text;
+    if (block.type == BEGIN)
+    {
+        header = block.header;
+        written = 0;
+        matching = header.kind != RESULT_FLOW;
+        weighted = header.kind == RESULT_ASSIGNMENT;
+        if (format == EXPORT_BINARY)
+        {
+            failed |= fwrite(&header, sizeof(header), 1, file) != 1;
+            return;
+        }
+        if (format == EXPORT_JSON)
+        {
+            snprintf(line, sizeof(line), "{\"kind\": \"%s\", \"vertices\": %d, \"source\": %d, \"sink\": %d, \"value\": %lld,\n \"edges\": [",
+                     weighted ? "assignment" : matching ? "matching" : "flow", header.n, header.source, header.sink, (long long)header.value);
+        }
+        else
+        {
+            snprintf(line, sizeof(line), "%s {\n  label=\"%s %lld\";\n", matching ? "graph matching" : "digraph flow",
+                     weighted ? "total weight" : matching ? "matching size" : "max flow", (long long)header.value);
+        }
+        write_text(line);
+        return;
+    }
+
+    if (block.type == EDGES)
+    {
+        if (format == EXPORT_BINARY)
+        {
+            size_t k = block.records.size();
+            failed |= fwrite(block.records.data(), sizeof(ResultRecord), k, file) != k;
+            written += k;
+            return;
+        }
+        for (size_t i = 0; i < block.records.size(); i++, written++)
+        {
+            const ResultRecord &r = block.records[i];
+            bool marked = r.flags & (RESULT_CUT | RESULT_MATCHED);
+            if (format == EXPORT_JSON && weighted)
+            {
+                snprintf(line, sizeof(line), "%s\n  {\"u\": %d, \"v\": %d, \"weight\": %lld, \"matched\": %s}", written ? "," : "",
+                         r.u, r.v, (long long)r.capacity, marked ? "true" : "false");
+            }
+            else if (format == EXPORT_JSON && matching)
+            {
+                snprintf(line, sizeof(line), "%s\n  {\"u\": %d, \"v\": %d, \"matched\": %s}", written ? "," : "", r.u, r.v,
+                         marked ? "true" : "false");
+            }
+            else if (format == EXPORT_JSON)
+            {
+                snprintf(line, sizeof(line), "%s\n  {\"u\": %d, \"v\": %d, \"capacity\": %lld, \"flow\": %lld, \"cut\": %s}",
+                         written ? "," : "", r.u, r.v, (long long)r.capacity, (long long)r.flow, marked ? "true" : "false");
+            }
+            else if (matching)
+            {
+                // left and right ids overlap, so the two sides get their own node names
+                snprintf(line, sizeof(line), "  L%d -- R%d%s;\n", r.u, r.v, marked ? " [color=red, penwidth=2]" : "");
+            }
+            else
+            {
+                snprintf(line, sizeof(line), "  %d -> %d [label=\"%lld/%lld\"%s];\n", r.u, r.v, (long long)r.flow,
+                         (long long)r.capacity, marked ? ", color=red, penwidth=2" : "");
+            }
+            text += line;
+        }
+        write_text(text);
+        return;
+    }
+
+    if (block.type == SIDES)
+    {
+        if (format == EXPORT_BINARY)
+        {
+            size_t k = block.sides.size();
+            failed |= fwrite(block.sides.data(), 1, k, file) != k;
+            return;
+        }
+        text = format == EXPORT_JSON ? "],\n \"source_side\": [" : "";
+        bool first = true;
+        for (size_t v = 0; v < block.sides.size(); v++)
+        {
+            if (!block.sides[v])
+            {
+                continue;
+            }
+            if (format == EXPORT_JSON)
+            {
+                snprintf(line, sizeof(line), "%s%d", first ? "" : ", ", (int)v);
+            }
+            else
+            {
+                snprintf(line, sizeof(line), "  %d [style=filled, fillcolor=lightblue];\n", (int)v);
+            }
+            text += line;
+            first = false;
+        }
+        write_text(text);
+        return;
+    }
+
+    // END: a JSON result without sides still has its edge array open
+    if (format == EXPORT_BINARY)
+    {
+        failed |= written != header.m;
+        return;
+    }
+    write_text(format == EXPORT_JSON ? "]}\n" : "}\n");
+}
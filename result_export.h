@@ -0,0 +1,141 @@
+#ifndef RESULT_EXPORT_H
+#define RESULT_EXPORT_H
+
+#include <vector>
+#include <deque>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdint>
+using namespace std;
+
+/**
+ * @brief File formats ResultWriter can produce.
+ */
+enum ExportFormat
+{
+    EXPORT_JSON,  // one object with the totals, an "edges" array and the source side
+    EXPORT_DOT,   // Graphviz digraph, cut and matched edges drawn bold red
+    EXPORT_BINARY // ResultHeader, m ResultRecord entries, then one side byte per vertex
+};
+
+const uint32_t RESULT_VERSION = 1;
+const uint32_t RESULT_FLOW = 0;     // ResultHeader::kind of a max-flow result
+const uint32_t RESULT_MATCHING = 1; // ResultHeader::kind of a matching result
+const uint32_t RESULT_ASSIGNMENT = 2; // ResultHeader::kind of a maximum weight matching, the value is its weight
+const uint32_t RESULT_CUT = 1;      // ResultRecord::flags: the edge crosses the minimum cut
+const uint32_t RESULT_MATCHED = 2;  // ResultRecord::flags: the edge is in the matching
+
+/**
+ * @brief Header of a binary result, followed by m ResultRecord entries and, for flows, n side bytes.
+ */
+struct ResultHeader
+{
+    char magic[8];       // "FFGRSLT" and a zero byte
+    uint32_t version;    // RESULT_VERSION
+    uint32_t byte_order; // 0x01020304 as stored by the machine that wrote the file
+    uint32_t kind;       // RESULT_FLOW, RESULT_MATCHING or RESULT_ASSIGNMENT
+    int32_t n, source, sink; // source and sink are -1 for a matching
+    int64_t value;       // max flow, matching size or matching weight
+    int64_t m;           // records that follow
+};
+
+/**
+ * @brief One edge of a result: its ends, capacity, flow and RESULT_CUT / RESULT_MATCHED flags.
+ */
+struct ResultRecord
+{
+    int32_t u, v;
+    int64_t capacity, flow;
+    uint32_t flags, reserved;
+};
+
+/**
+ * @brief Writes a flow or matching result from a background thread.
+ *
+ * The solver hands over the result in batches of records and goes on; formatting and file
+ * writes happen on the writer thread, so nothing the solver times waits for the disk. A
+ * result is begin(), any number of add_edges() batches, optionally add_sides(), then end().
+ */
+class ResultWriter
+{
+public:
+    ResultWriter();
+    ~ResultWriter();
+
+    /**
+     * @brief Opens the output file and starts the writer thread.
+     *
+     * @param path The file to write.
+     * @param format The format to write it in.
+     * @param error Receives the reason on failure.
+     * @return true on success.
+     */
+    bool open(const string &path, ExportFormat format, string &error);
+
+    // method to start a result of the given kind, the edge count is only needed by the binary format
+    void begin(uint32_t kind, int n, int source, int sink, long long value, long long m);
+
+    // method to queue a batch of edge records
+    void add_edges(vector<ResultRecord> &batch);
+
+    // method to queue the side of every vertex, 1 for the source side of the cut
+    void add_sides(vector<char> &sides);
+
+    // method to close the result
+    void end();
+
+    /**
+     * @brief Waits for the writer thread to write everything queued and closes the file.
+     *
+     * @param error Receives the reason if a write failed.
+     * @return true if the whole result reached the file.
+     */
+    bool finish(string &error);
+
+private:
+    /**
+     * @brief One piece of the result on its way to the writer thread.
+     */
+    struct Block
+    {
+        int type; // BEGIN, EDGES, SIDES or END
+        ResultHeader header;
+        vector<ResultRecord> records;
+        vector<char> sides;
+    };
+    enum
+    {
+        BEGIN,
+        EDGES,
+        SIDES,
+        END
+    };
+
+    FILE *file;
+    string path;
+    ExportFormat format;
+    ResultHeader header; // of the result being written, kept by the writer thread
+    long long written;   // records written so far
+    bool failed;
+    thread writer;
+    mutex queue_lock;
+    condition_variable queue_signal;
+    deque<Block> queue;
+    bool closing;
+
+    void push(Block &block);
+    void run();
+    void write_block(const Block &block);
+    void write_text(const string &text);
+
+    ResultWriter(const ResultWriter &);
+    ResultWriter &operator=(const ResultWriter &);
+};
+
+// method to pick the format from the file extension: .dot, .bin, anything else is JSON
+ExportFormat export_format_of(const string &path);
+
+#endif
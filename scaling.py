@@ -0,0 +1,75 @@
+import os
+import random
+import shutil
+import subprocess
+import sys
+import tempfile
+
+# speedup of `--algo parallel` over the single-thread engines on large seeded instances:
+#   python scaling.py [./FF_modified] [edges] [thread counts, e.g. 1,2,4,8]
+binary = os.path.abspath(sys.argv[1] if len(sys.argv) > 1 else "FF_modified")
+edges = int(sys.argv[2]) if len(sys.argv) > 2 else 1000000
+threads = [int(t) for t in sys.argv[3].split(",")] if len(sys.argv) > 3 else [1, 2, 4, 8, 16, 32]
+repeats = 3
+
+
+# writes an instance in the inputTask1.txt format, the source is 0 and the sink n - 1
+def write_instance(path, family, edges, seed):
+    rng = random.Random(seed)
+    lines = []
+    if family == "sparse":
+        # random graph with out-degree 4
+        n = max(2, edges // 4)
+        for _ in range(edges):
+            u = rng.randrange(n)
+            v = rng.randrange(n - 1)
+            lines.append("%d %d %d" % (u, v + (v >= u), rng.randint(1, 1000)))
+    else:
+        # layers of equal width, every vertex linked to 4 vertices of the next layer
+        width = max(1, int((edges / 4) ** 0.5))
+        layers = max(1, edges // (4 * width))
+        n = layers * width + 2
+        for i in range(width):
+            lines.append("0 %d %d" % (1 + i, 1000000))
+            lines.append("%d %d %d" % (1 + (layers - 1) * width + i, n - 1, 1000000))
+        for layer in range(layers - 1):
+            for i in range(width):
+                for _ in range(4):
+                    u = 1 + layer * width + i
+                    v = 1 + (layer + 1) * width + rng.randrange(width)
+                    lines.append("%d %d %d" % (u, v, rng.randint(1, 1000)))
+    with open(path, "w") as f:
+        f.write("%d\n0 %d\n%s\n" % (n, n - 1, "\n".join(lines)))
+
+
+# median execution time in microseconds and the flow value of one engine on the instance in directory
+def measure(directory, arguments):
+    times, flows = [], set()
+    for _ in range(repeats):
+        out = subprocess.run([binary] + arguments, cwd=directory, stdout=subprocess.PIPE,
+                             stderr=subprocess.DEVNULL, universal_newlines=True).stdout
+        for line in out.splitlines():
+            if line.startswith("max flow is :-"):
+                flows.add(int(line.split()[-1]))
+            if line.startswith("Execution time:"):
+                times.append(int(line.split()[2]))
+    times.sort()
+    return times[len(times) // 2], flows
+
+
+# the times include reading the file, which every engine pays alike
+print("family,engine,threads,median_us,speedup_vs_hlpp,speedup_vs_dinic,flow")
+for family in ["sparse", "layered"]:
+    directory = tempfile.mkdtemp()
+    write_instance(os.path.join(directory, "inputTask1.txt"), family, edges, 1)
+    runs = [("dinic", 1, ["--algo", "dinic"]), ("hlpp", 1, ["--algo", "hlpp"])]
+    runs += [("parallel", k, ["--algo", "parallel", "--threads", str(k)]) for k in threads]
+    results = [(engine, k) + measure(directory, arguments) for engine, k, arguments in runs]
+    base = dict((engine, time) for engine, k, time, flows in results if engine != "parallel")
+    values = set().union(*[flows for engine, k, time, flows in results])
+    for engine, k, time, flows in results:
+        print("%s,%s,%d,%d,%.2f,%.2f,%s" % (family, engine, k, time, base["hlpp"] / float(time),
+                                            base["dinic"] / float(time), "/".join(map(str, sorted(flows)))))
+    if len(values) != 1:
+        print("%s: the engines disagree on the flow value" % family, file=sys.stderr)
+    shutil.rmtree(directory)
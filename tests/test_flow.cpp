@@ -0,0 +1,479 @@
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstdlib>
+#include <unistd.h>
+#include "../maxflow.h"
+#include "../gomory_hu.h"
+#include "../matching.h"
+#include "../assignment.h"
+#include "../graph_families.h"
+using namespace std;
+
+/*
+ * Cross-checks of the engines against each other and against brute force on small graphs:
+ *
+ *     g++ -O2 -pthread -o test_flow tests/test_flow.cpp maxflow.cpp gomory_hu.cpp matching.cpp assignment.cpp
+ *     ./test_flow
+ *
+ * Every failed check prints one line, and the exit status is 1 if any check failed.
+ */
+
+int checks = 0, failures = 0;
+
+// records one check, printing what was expected when it fails
+void check(bool ok, const string &what)
+{
+    checks++;
+    if (!ok)
+    {
+        failures++;
+        cout << "FAIL " << what << endl;
+    }
+}
+
+/**
+ * @brief A flow network as a plain edge list, so every engine can get a fresh graph of it.
+ */
+struct EdgeList
+{
+    int n, source, sink;
+    vector<int> u, v;
+    vector<long long> capacity, cost;
+
+    EdgeList() : n(0), source(0), sink(0) {}
+
+    // generate_family streams into these three methods
+    void begin(int n, int source, int sink, long long)
+    {
+        this->n = n;
+        this->source = source;
+        this->sink = sink;
+    }
+    void edge(int a, int b, long long c, long long w = 0)
+    {
+        u.push_back(a);
+        v.push_back(b);
+        capacity.push_back(c);
+        cost.push_back(w);
+    }
+    void end() {}
+
+    // method to build a graph of the edge list with the given engine
+    template <class Cap>
+    void build(BasicGraph<Cap> &G, FlowAlgorithm algorithm, bool scaling) const
+    {
+        G.reset(n);
+        G.algorithm = algorithm;
+        G.capacity_scaling = scaling;
+        G.threads = 2;
+        for (size_t i = 0; i < u.size(); i++)
+        {
+            G.add_edge(u[i], v[i], (Cap)capacity[i], cost[i]);
+        }
+    }
+};
+
+// small deterministic generator for the random cases, independent of the standard library
+FamilyRandom random_source(12345);
+
+int below(int k)
+{
+    return random_source.below(k);
+}
+
+// a random graph with n vertices, m edges without loops and capacities in [0, max_capacity]
+EdgeList random_graph(int n, int m, int max_capacity)
+{
+    EdgeList list;
+    list.begin(n, 0, n - 1, m);
+    for (int i = 0; i < m; i++)
+    {
+        int a = below(n), b = below(n - 1);
+        list.edge(a, b + (b >= a), below(max_capacity + 1));
+    }
+    return list;
+}
+
+// checks that the edges of G hold a feasible flow of the given value from source to sink
+template <class Cap>
+bool is_flow(const BasicGraph<Cap> &G, int source, int sink, long long value)
+{
+    vector<long long> net(G.n, 0);
+    for (int i = 0; i < G.m; i++)
+    {
+        long long flow = G.edges[i].flow;
+        if (flow < 0 || flow > (long long)G.edges[i].capacity)
+        {
+            return false;
+        }
+        net[G.edges[i].u] -= flow;
+        net[G.edges[i].v] += flow;
+    }
+    for (int w = 0; w < G.n; w++)
+    {
+        if (w != source && w != sink && net[w] != 0)
+        {
+            return false;
+        }
+    }
+    return net[sink] == value && net[source] == -value;
+}
+
+// checks that the cut of G separates source from sink and that its edges add up to value
+template <class Cap>
+bool is_cut(BasicGraph<Cap> &G, int source, int sink, long long value)
+{
+    CutResult cut = G.min_cut(source, sink);
+    vector<char> side(G.n, 0);
+    for (size_t i = 0; i < cut.source_side.size(); i++)
+    {
+        side[cut.source_side[i]] = 1;
+    }
+    long long crossing = 0;
+    for (int i = 0; i < G.m; i++)
+    {
+        if (side[G.edges[i].u] && !side[G.edges[i].v])
+        {
+            crossing += G.edges[i].capacity;
+        }
+    }
+    return cut.value == value && side[source] && !side[sink] && crossing == value;
+}
+
+// solves the edge list with every engine, with and without capacity scaling, and compares the results
+template <class Cap>
+void check_engines(const EdgeList &list, const string &name)
+{
+    const char *engines[] = {"ff", "ek", "dinic", "hlpp", "parallel"};
+    long long reference = -1;
+    for (int k = 0; k < 5; k++)
+    {
+        for (int scaling = 0; scaling < 2; scaling++)
+        {
+            BasicGraph<Cap> G(1);
+            list.build(G, (FlowAlgorithm)k, scaling);
+            long long value = G.max_flow(list.source, list.sink);
+            string what = name + " " + engines[k] + (scaling ? " --scaling" : "");
+            if (reference < 0)
+            {
+                reference = value;
+            }
+            check(value == reference, what + ": max flow " + to_string(value) + ", expected " + to_string(reference));
+            check(is_flow(G, list.source, list.sink, value), what + ": the edges do not hold a flow of the returned value");
+            check(is_cut(G, list.source, list.sink, value), what + ": the cut does not match the flow");
+        }
+    }
+}
+
+// every engine on every seeded family, and the matching engines against the flow on the bipartite one
+void test_families()
+{
+    for (int f = 0; f < FAMILY_COUNT; f++)
+    {
+        for (uint64_t seed = 1; seed <= 3; seed++)
+        {
+            EdgeList list;
+            generate_family(FAMILY_NAMES[f], 2000, seed, list);
+            string name = string(FAMILY_NAMES[f]) + " seed " + to_string(seed);
+            check_engines<int>(list, name);
+            check_engines<long long>(list, name + " int64");
+            bool unit = true;
+            for (size_t i = 0; i < list.capacity.size(); i++)
+            {
+                unit = unit && list.capacity[i] <= 1;
+            }
+            if (unit)
+            {
+                check_engines<bool>(list, name + " unit");
+            }
+        }
+    }
+    for (uint64_t seed = 1; seed <= 3; seed++)
+    {
+        EdgeList network, pairs;
+        FamilyRandom first(seed), second(seed);
+        bipartite_family(2000, first, network, true);
+        bipartite_family(2000, second, pairs, false);
+        Graph G(1);
+        network.build(G, DINIC, false);
+        long long flow = G.max_flow(network.source, network.sink);
+        BipartiteGraph sparse(pairs.n), dense(pairs.n);
+        for (size_t i = 0; i < pairs.u.size(); i++)
+        {
+            sparse.add_edge(pairs.u[i], pairs.v[i]);
+            dense.add_edge(pairs.u[i], pairs.v[i]);
+        }
+        string name = "bipartite pairs seed " + to_string(seed);
+        check(sparse.hopcroft_karp() == flow, name + ": hopcroft_karp differs from the max flow");
+        check(dense.dense_matching() == flow, name + ": dense_matching differs from the max flow");
+    }
+}
+
+// a pair with the same source and sink has no flow, and a file naming such a pair does not load
+void test_source_is_sink()
+{
+    EdgeList list = random_graph(6, 12, 9);
+    for (int k = 0; k < 5; k++)
+    {
+        Graph G(1);
+        list.build(G, (FlowAlgorithm)k, false);
+        check(G.max_flow(2, 2) == 0, "max_flow(2, 2) with engine " + to_string(k) + " is not 0");
+    }
+    char path[] = "/tmp/test_flow_XXXXXX";
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        check(false, "cannot create a temporary file");
+        return;
+    }
+    const char text[] = "3\n1 1\n0 1 5\n1 2 5\n";
+    bool written = write(fd, text, sizeof(text) - 1) == (ssize_t)sizeof(text) - 1;
+    close(fd);
+    Graph G(1);
+    int source, sink;
+    string error;
+    check(written && !load_graph(path, G, source, sink, error), "a file whose source is its sink was loaded");
+    unlink(path);
+}
+
+// re-solves after set_capacity, add_edge and remove_edge agree with a fresh solve of the changed graph
+void test_warm_resolve()
+{
+    for (int round = 0; round < 300; round++)
+    {
+        int n = 2 + below(9);
+        EdgeList list = random_graph(n, below(25), 20);
+        FlowAlgorithm algorithm = (FlowAlgorithm)below(5);
+        bool scaling = below(2);
+        Graph G(1);
+        list.build(G, algorithm, scaling);
+        G.max_flow(list.source, list.sink);
+        for (int step = 0; step < 6; step++)
+        {
+            int change = below(3);
+            if (change == 0 && G.m > 0)
+            {
+                int edge = below(G.m);
+                list.capacity[edge] = below(21);
+                G.set_capacity(edge, list.capacity[edge]);
+            }
+            else if (change == 1 && G.m > 0)
+            {
+                int edge = below(G.m);
+                list.capacity[edge] = 0;
+                G.remove_edge(edge);
+            }
+            else
+            {
+                int a = below(n), b = below(n - 1);
+                list.edge(a, b + (b >= a), below(21));
+                G.add_edge(list.u.back(), list.v.back(), list.capacity.back());
+            }
+            Graph F(1);
+            list.build(F, algorithm, scaling);
+            long long warm = G.max_flow(list.source, list.sink), fresh = F.max_flow(list.source, list.sink);
+            string what = "warm re-solve round " + to_string(round) + " step " + to_string(step);
+            check(warm == fresh, what + ": " + to_string(warm) + ", a fresh solve gives " + to_string(fresh));
+            check(is_flow(G, list.source, list.sink, warm), what + ": the edges do not hold the flow");
+        }
+    }
+}
+
+// every pair of the Gomory-Hu tree against a max flow on the graph with both directions of every edge
+void test_gomory_hu()
+{
+    for (int round = 0; round < 60; round++)
+    {
+        int n = 2 + below(9);
+        EdgeList list = random_graph(n, below(20), 15);
+        Graph G(1), both(1);
+        list.build(G, DINIC, false);
+        both.reset(n);
+        for (size_t i = 0; i < list.u.size(); i++)
+        {
+            both.add_edge(list.u[i], list.v[i], list.capacity[i]);
+            both.add_edge(list.v[i], list.u[i], list.capacity[i]);
+        }
+        GomoryHuTree T;
+        T.build(G, 1 + below(3), (FlowAlgorithm)below(5));
+        for (int a = 0; a < n; a++)
+        {
+            for (int b = a + 1; b < n; b++)
+            {
+                long long expected = both.max_flow(a, b), tree = T.min_cut_value(a, b);
+                vector<pair<int, int>> cut = T.cut_edges(a, b);
+                long long crossing = 0;
+                for (size_t i = 0; i < list.u.size(); i++)
+                {
+                    for (size_t j = 0; j < cut.size(); j++)
+                    {
+                        if ((cut[j].first == list.u[i] && cut[j].second == list.v[i]) ||
+                            (cut[j].first == list.v[i] && cut[j].second == list.u[i]))
+                        {
+                            crossing += list.capacity[i];
+                            break;
+                        }
+                    }
+                }
+                string what = "gomory-hu round " + to_string(round) + " pair " + to_string(a) + " " + to_string(b);
+                check(tree == expected, what + ": " + to_string(tree) + ", max flow gives " + to_string(expected));
+                check(crossing == expected, what + ": the listed cut edges do not add up to the cut");
+            }
+        }
+    }
+}
+
+// tries every flow of every edge of a tiny graph for the cheapest of the maximum flows
+void brute_min_cost(const EdgeList &list, long long &best_value, long long &best_cost)
+{
+    int m = list.u.size();
+    vector<long long> flow(m, 0);
+    best_value = -1;
+    best_cost = 0;
+    for (;;)
+    {
+        vector<long long> net(list.n, 0);
+        long long cost = 0;
+        for (int i = 0; i < m; i++)
+        {
+            net[list.u[i]] -= flow[i];
+            net[list.v[i]] += flow[i];
+            cost += flow[i] * list.cost[i];
+        }
+        bool conserved = true;
+        for (int w = 0; w < list.n; w++)
+        {
+            conserved = conserved && (w == list.source || w == list.sink || net[w] == 0);
+        }
+        long long value = net[list.sink];
+        if (conserved && (value > best_value || (value == best_value && cost < best_cost)))
+        {
+            best_value = value;
+            best_cost = cost;
+        }
+        int i = 0;
+        while (i < m && flow[i] == list.capacity[i])
+        {
+            flow[i++] = 0;
+        }
+        if (i == m)
+        {
+            return;
+        }
+        flow[i]++;
+    }
+}
+
+// both min-cost engines against brute force, with negative costs for the one that cancels cycles
+void test_min_cost()
+{
+    for (int round = 0; round < 300; round++)
+    {
+        int n = 2 + below(4);
+        EdgeList list = random_graph(n, below(7), 3);
+        bool negative = below(2);
+        for (size_t i = 0; i < list.cost.size(); i++)
+        {
+            list.cost[i] = negative ? below(15) - 5 : below(10);
+        }
+        long long value, cost;
+        brute_min_cost(list, value, cost);
+        for (int k = 0; k < 2; k++)
+        {
+            if (k == 0 && negative)
+            {
+                continue;
+            }
+            Graph G(1);
+            list.build(G, DINIC, false);
+            G.cost_algorithm = (CostAlgorithm)k;
+            long long got_cost = 0;
+            long long got = G.min_cost_flow(list.source, list.sink, got_cost);
+            string what = string(k ? "cost scaling" : "successive shortest paths") + " round " + to_string(round);
+            check(got == value && got_cost == cost, what + ": flow " + to_string(got) + " cost " + to_string(got_cost) +
+                                                        ", brute force gives " + to_string(value) + " cost " + to_string(cost));
+            check(is_flow(G, list.source, list.sink, got), what + ": the edges do not hold the flow");
+        }
+    }
+}
+
+// tries every matching of a tiny weighted bipartite graph, left vertex by left vertex over the free right ones
+long long brute_assignment(int n, const vector<int> &u, const vector<int> &v, const vector<long long> &weight)
+{
+    vector<long long> best(1 << n, 0), next;
+    for (int a = 0; a < n; a++)
+    {
+        next = best;
+        for (size_t i = 0; i < u.size(); i++)
+        {
+            if (u[i] != a || weight[i] <= 0)
+            {
+                continue;
+            }
+            for (int used = 0; used < (1 << n); used++)
+            {
+                if (!(used >> v[i] & 1))
+                {
+                    next[used | 1 << v[i]] = max(next[used | 1 << v[i]], best[used] + weight[i]);
+                }
+            }
+        }
+        best = next;
+    }
+    long long result = 0;
+    for (size_t used = 0; used < best.size(); used++)
+    {
+        result = max(result, best[used]);
+    }
+    return result;
+}
+
+// the auction and the Hungarian method against brute force, with parallel edges and non-positive weights
+void test_assignment()
+{
+    for (int round = 0; round < 300; round++)
+    {
+        int n = 1 + below(7), m = below(3 * n + 1);
+        vector<int> u, v;
+        vector<long long> weight;
+        for (int i = 0; i < m; i++)
+        {
+            u.push_back(below(n));
+            v.push_back(below(n));
+            weight.push_back(below(30) - 5);
+        }
+        long long expected = brute_assignment(n, u, v, weight);
+        for (int k = 0; k < 2; k++)
+        {
+            WeightedAssignment W(n);
+            W.threads = 1 + below(3);
+            for (int i = 0; i < m; i++)
+            {
+                W.add_edge(u[i], v[i], weight[i]);
+            }
+            long long got = k ? W.hungarian() : W.auction();
+            bool matching = true;
+            for (int a = 0; a < n; a++)
+            {
+                matching = matching && (W.match_left[a] < 0 || W.match_right[W.match_left[a]] == a);
+            }
+            string what = string(k ? "hungarian" : "auction") + " round " + to_string(round);
+            check(got == expected, what + ": weight " + to_string(got) + ", brute force gives " + to_string(expected));
+            check(matching && W.matching_weight() == got, what + ": the matched pairs do not add up to the weight");
+        }
+    }
+}
+
+int main()
+{
+    test_families();
+    test_source_is_sink();
+    test_warm_resolve();
+    test_gomory_hu();
+    test_min_cost();
+    test_assignment();
+    cout << checks << " checks, " << failures << " failed" << endl;
+    return failures ? 1 : 0;
+}